@@ -10,20 +10,173 @@
 #define JET_CONFIG_CONFIG_HEADER_GUARD
 
 #include "config_source.hpp"
-#include <boost/lexical_cast.hpp>
+#include "config_conversion.hpp"
 #include <boost/optional.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
 #include <vector>
 
 namespace jet
 {
 
+namespace detail
+{
+
+//...numeric and boolean representations of property value, converted once when config is locked.
+//...'array' is offset of elements of array property in config storage (-1 if it's just this value)
+struct config_value
+{
+    enum : std::uint32_t { integer_flag = 1, floating_flag = 2, boolean_flag = 4 };
+    std::int64_t integer;
+    double floating;
+    std::uint32_t flags;
+    std::uint32_t array;
+};
+
+//...returns false if cached representation is not available and value has to be converted from string
+template<typename T, typename enable = void>
+struct config_value_cast
+{
+    static bool get(const config_value&, T&) { return false; }
+};
+
+template<typename T>
+struct config_value_cast<T, typename std::enable_if<is_config_integer<T>::value>::type>
+{
+    static bool get(const config_value& value, T& result)
+    {
+        if(!(value.flags & config_value::integer_flag))
+            return false;
+        if(std::is_signed<T>::value)
+        {
+            if( value.integer < static_cast<std::int64_t>(std::numeric_limits<T>::min()) ||
+                value.integer > static_cast<std::int64_t>(std::numeric_limits<T>::max()) )
+                return false;
+        }
+        else if(value.integer < 0 ||
+            static_cast<std::uint64_t>(value.integer) > static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+            return false;
+        result = static_cast<T>(value.integer);
+        return true;
+    }
+};
+
+template<>
+struct config_value_cast<double>
+{
+    static bool get(const config_value& value, double& result)
+    {
+        if(!(value.flags & config_value::floating_flag))
+            return false;
+        result = value.floating;
+        return true;
+    }
+};
+
+template<>
+struct config_value_cast<bool>
+{
+    static bool get(const config_value& value, bool& result)
+    {
+        if(!(value.flags & config_value::boolean_flag))
+            return false;
+        result = 0 != value.integer;
+        return true;
+    }
+};
+
+//...elements of array property converted when config is locked, 'flags' are the ones all elements have
+struct config_array_data
+{
+    const std::int64_t* integers;
+    const double* floatings;
+    std::size_t size;
+    std::uint32_t flags;
+};
+
+template<typename T>
+struct config_array_cast;
+
+template<>
+struct config_array_cast<std::int64_t>
+{
+    static const std::uint32_t flag = config_value::integer_flag;
+    static const std::int64_t* get(const config_array_data& data) { return data.integers; }
+};
+
+template<>
+struct config_array_cast<double>
+{
+    static const std::uint32_t flag = config_value::floating_flag;
+    static const double* get(const config_array_data& data) { return data.floatings; }
+};
+
+}//namespace detail
+
+class config_node;
+struct config_image;
+class config_view;
+template<typename node_type>
+class basic_config_children;
+using config_children = basic_config_children<config_node>;
+using config_view_children = basic_config_children<config_view>;
+
+//...property which was added, removed or changed between two configs, see diff()
+struct config_change
+{
+    std::string path;//...relative to compared nodes
+    boost::optional<std::string> old_value, new_value;//...old_value is none for added property, new_value for removed
+};
+using config_changes = std::vector<config_change>;
+
+//...property resolved and converted once (locked config is immutable), so reading it
+//...doesn't need any lookup, conversion or allocation. It's valid as long as its config is alive
+template<typename T>
+class config_key
+{
+    static_assert(std::is_arithmetic<T>::value, "config_key supports only arithmetic types");
+public:
+    config_key(): value_{} {}
+    T get() const { return value_; }
+private:
+    friend class config_view;
+    explicit config_key(const T& value): value_{value} {}
+    T value_;
+};
+
+//...contiguous elements of array property, see get_array(). It refers to the locked config storage
+//...and is valid as long as config is alive
+template<typename T>
+class config_array
+{
+public:
+    using value_type     = T;
+    using iterator       = const T*;
+    using const_iterator = const T*;
+
+    config_array(): data_{}, size_{} {}
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    const T& operator[](std::size_t index) const { return data_[index]; }
+private:
+    friend class config_view;
+    config_array(const T* data, std::size_t size): data_{data}, size_{size} {}
+    const T* data_;
+    std::size_t size_;
+};
+
 class config_node
 {
+protected:
     class impl;
-    config_node(
-        const std::string& path,
-        const std::shared_ptr<impl>& impl,
-        const void* tree_node);
+    config_node(const std::shared_ptr<impl>& impl, const void* tree_node);
 public:
     config_node(const config_node& copee);
     config_node& operator=(const config_node& copee);
@@ -31,100 +184,344 @@ public:
     std::string name() const;//...name := app_name [ '..' instance_name ] [ '.' path ]
     const std::string& app_name() const;
     const std::string& instance_name() const;
-    const std::string& path() const { return path_; }
-    const std::string node_name() const; //...this is the last part of 'path', e.g. for path 'long.path.to.element' node_name equal to 'element'
+    std::string path() const;
+    std::string node_name() const; //...this is the last part of 'path', e.g. for path 'long.path.to.element' node_name equal to 'element'
+    //...the same without copying: views refer to interned keys (or to config image) and are valid as long as config is alive
+    boost::string_ref path_view() const;
+    boost::string_ref node_name_view() const;
     
-    config_node get_node(const std::string& path) const;
-    boost::optional<config_node> get_node_optional(const std::string& path) const;
-    std::vector<config_node> get_children_of(const std::string& path = std::string()) const;
+    config_node get_node(boost::string_ref path) const;
+    boost::optional<config_node> get_node_optional(boost::string_ref path) const;
+    std::vector<config_node> get_children_of(boost::string_ref path = boost::string_ref{}) const;
+    config_children children_of(boost::string_ref path = boost::string_ref{}) const;//...the same as get_children_of, but lazy
     
-    std::string get(const std::string& attr_name = std::string()) const;
+    std::string get(boost::string_ref attr_name = boost::string_ref{}) const;
     template<typename T>
-    T get(const std::string& attr_name = std::string()) const;
+    T get(boost::string_ref attr_name = boost::string_ref{}) const;
     
-    boost::optional<std::string> get_optional(const std::string& attr_name = std::string()) const;
+    boost::optional<std::string> get_optional(boost::string_ref attr_name = boost::string_ref{}) const;
     template<typename T>
-    boost::optional<T> get_optional(const std::string& attr_name = std::string()) const;
+    boost::optional<T> get_optional(boost::string_ref attr_name = boost::string_ref{}) const;
     
-    std::string get(const std::string& attr_name, const std::string& default_value) const;
+    std::string get(boost::string_ref attr_name, const std::string& default_value) const;
+    template<typename T>
+    T get(boost::string_ref attr_name, const T& default_value) const;
+
+    //...views refer to the locked config storage and are valid as long as config is alive
+    boost::string_ref get_view(boost::string_ref attr_name = boost::string_ref{}) const;
+    boost::optional<boost::string_ref> get_view_optional(boost::string_ref attr_name = boost::string_ref{}) const;
+
     template<typename T>
-    T get(const std::string& attr_name, const T& default_value) const;
+    config_key<T> key(boost::string_ref attr_name) const;//...throws if property doesn't exist or can't be converted
+
+    //...array property: values of the property and of its repeated nodes, each one split by commas,
+    //...e.g. '<port>80</port><port>81, 82</port>' is array 'port' of 80, 81, 82. Elements are converted
+    //...when config is locked and stored contiguously, so reading array costs one lookup.
+    //...T is std::int64_t or double, throws if property doesn't exist or any element can't be converted
+    template<typename T>
+    config_array<T> get_array(boost::string_ref attr_name = boost::string_ref{}) const;
+
+    config_view view() const;
 protected:
-    config_node(const std::string& app_name, const std::string& instance_name);
+    config_node(const std::string& app_name, const std::string& instance_name, bool ignore_case);
+    explicit config_node(const config_image& image);
     void merge(const config_source& source);
     void lock();
+    void save(const config_image& image) const;
+    std::size_t memory_usage() const;
     void print(std::ostream& os) const;
 private:
-    void throw_value_conversion_error[[noreturn]](const std::string& attr_name, const std::string& value) const;
     friend std::ostream& operator<<(std::ostream& os, const config_node& config);
+    friend class config_view;
+    template<typename node_type>
+    friend class basic_config_children;
+    friend class config_factory;
+    config_node(std::nullptr_t, const void* tree_node): tree_node_{tree_node} {}
     //...
-    std::string path_;
     std::shared_ptr<impl> impl_;
     const void* tree_node_;
 };
 
 using config_nodes = std::vector<config_node>;
 
+//...non-owning config node: two pointers, trivially copyable, no reference counting.
+//...It has the same read interface as config_node, but it's valid only as long as the
+//...config it refers to is alive, so the owner of config has to guarantee its lifetime
+class config_view
+{
+public:
+    config_view(): impl_{}, tree_node_{} {}
+    config_view(const config_node& node);
+    std::string name() const;//...name := app_name [ '..' instance_name ] [ '.' path ]
+    const std::string& app_name() const;
+    const std::string& instance_name() const;
+    std::string path() const;
+    std::string node_name() const;
+    boost::string_ref path_view() const;
+    boost::string_ref node_name_view() const;
+
+    config_view get_node(boost::string_ref path) const;
+    boost::optional<config_view> get_node_optional(boost::string_ref path) const;
+    config_view_children children_of(boost::string_ref path = boost::string_ref{}) const;
+
+    std::string get(boost::string_ref attr_name = boost::string_ref{}) const;
+    template<typename T>
+    T get(boost::string_ref attr_name = boost::string_ref{}) const;
+
+    boost::optional<std::string> get_optional(boost::string_ref attr_name = boost::string_ref{}) const;
+    template<typename T>
+    boost::optional<T> get_optional(boost::string_ref attr_name = boost::string_ref{}) const;
+
+    std::string get(boost::string_ref attr_name, const std::string& default_value) const;
+    template<typename T>
+    T get(boost::string_ref attr_name, const T& default_value) const;
+
+    boost::string_ref get_view(boost::string_ref attr_name = boost::string_ref{}) const;
+    boost::optional<boost::string_ref> get_view_optional(boost::string_ref attr_name = boost::string_ref{}) const;
+
+    template<typename T>
+    config_key<T> key(boost::string_ref attr_name) const;
+
+    template<typename T>
+    config_array<T> get_array(boost::string_ref attr_name = boost::string_ref{}) const;
+private:
+    friend class config_node;
+    template<typename node_type>
+    friend class basic_config_children;
+    friend std::ostream& operator<<(std::ostream& os, const config_view& config);
+    friend config_changes diff(const config_view& from, const config_view& to);
+    config_view(const config_node::impl* impl, const void* tree_node): impl_{impl}, tree_node_{tree_node} {}
+    const detail::config_value& get_value(boost::string_ref attr_name, boost::string_ref& text) const;
+    const detail::config_value* get_value_optional(boost::string_ref attr_name, boost::string_ref& text) const;
+    void throw_value_conversion_error[[noreturn]](boost::string_ref attr_name, boost::string_ref value) const;
+    detail::config_array_data get_array_data(boost::string_ref attr_name) const;
+    void throw_array_conversion_error[[noreturn]](boost::string_ref attr_name, std::uint32_t flag) const;
+    //...
+    const config_node::impl* impl_;
+    const void* tree_node_;
+};
+
 extern std::ostream& operator<<(std::ostream& os, const config_node& config);
+extern std::ostream& operator<<(std::ostream& os, const config_view& config);
+
+//...compares properties of two nodes of locked configs. Repeated nodes are matched in order of
+//...occurrence. Subtrees which are equal in both are skipped, so it takes time proportional
+//...to the size of changed region rather than to the size of config. Subtrees are taken as equal
+//...when their 64 bit hashes are (properties are compared by value), so a change inside of
+//...subtree is missed if hashes collide, which happens with probability of about 2^-64
+config_changes diff(const config_view& from, const config_view& to);
+
+namespace detail
+{
+const void* next_config_node(const void* tree_node, std::size_t distance = 1);
+}//namespace detail
+
+//...range of child nodes. Iterator refers to the node which it holds, so iteration itself
+//...doesn't copy anything: to keep the node beyond iteration step just copy it
+template<typename node_type>
+class basic_config_children
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = node_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const node_type*;
+        using reference         = const node_type&;
+
+        reference operator*() const { return node_; }
+        pointer operator->() const { return &node_; }
+        iterator& operator++()
+        {
+            node_.tree_node_ = detail::next_config_node(node_.tree_node_);//...siblings are stored contiguously
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator prev{*this};
+            ++*this;
+            return prev;
+        }
+        bool operator==(const iterator& other) const { return node_.tree_node_ == other.node_.tree_node_; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+    private:
+        friend class basic_config_children;
+        explicit iterator(const node_type& node): node_(node) {}
+        node_type node_;
+    };
+    using const_iterator = iterator;
+
+    iterator begin() const { return iterator{first_}; }
+    iterator end() const
+    {
+        return iterator{node_type{nullptr, detail::next_config_node(first_.tree_node_, size_)}};
+    }
+    std::size_t size() const { return size_; }
+    bool empty() const { return !size_; }
+private:
+    friend class config_node;
+    friend class config_view;
+    basic_config_children(const node_type& first, std::size_t size): first_(first), size_{size} {}
+    node_type first_;
+    std::size_t size_;
+};
 
 struct config_lock {};
 extern const config_lock lock;//...this is used to lock config, that is to finish creation from config_source. Efectively it makes config immutable
 
+//...file with binary image of a locked config. Image is mapped into memory as is (no parsing),
+//...so it can be opened only on the same platform (byte order, layout) where it was saved
+struct config_image
+{
+    explicit config_image(const std::string& filename): filename_{filename} {}
+    const std::string& filename() const { return filename_; }
+private:
+    std::string filename_;
+};
+
+//...config is built (merged and locked) by one thread. Locked config is immutable: all its const
+//...members and members of nodes and views taken from it may be called by any number of threads
+//...at once without synchronization, reads take no locks and modify nothing shared except the
+//...reference counts of config_node copies (config_view doesn't have even them).
+//...Reads which race with lock() either throw (initialization isn't finished) or see the whole
+//...locked config, so config may be published to readers before it's locked
 class config: public config_node
 {
 public:
+    //...how property paths are matched by get/get_node/key after config is locked.
+    //...case_insensitive matches ASCII letters in any case without copying the path, names of
+    //...nodes keep their case. Of nodes whose paths differ only in case the first one is found
+    enum key_lookup { case_sensitive, case_insensitive };
+
     explicit config(
         const std::string& app_name,
-        const std::string& instance_name = std::string());
+        const std::string& instance_name = std::string(),
+        key_lookup lookup = case_sensitive);
+    explicit config(const config_image& image);//...config is locked and has the same content as saved one
+
+    void save(const config_image& image) const;//...config has to be locked
+    //...bytes of memory owned by config: size of image (allocated or mapped from file) when config
+    //...is locked, estimated heap size of merged tree (nodes and strings) before that.
+    //...Image of config created by config_factory doesn't include the base shared with other instances.
+    //...Key names of locked configs are shared by all of them and are counted by key_memory_usage()
+    std::size_t memory_usage() const;
+    //...bytes of process-wide table of key names of locked configs, name is freed with the last
+    //...config which has it
+    static std::size_t key_memory_usage();
 
     config& operator<<(const config_source& source);
+    config& operator<<(const std::vector<config_source>& sources);//...merged in order
     void operator<<(config_lock);
+private:
+    friend class config_factory;
+    explicit config(const std::shared_ptr<impl>& impl);
+};
+
+//...builds locked configs of many instances of one application from the same sources.
+//...Config of application (without instance) is merged and locked once by constructor, config of
+//...instance keeps only nodes changed by its instance nodes and reads the rest from the shared one,
+//...so instances cost memory and time proportional to their own differences.
+//...create() returns config equal to config{app_name, instance_name, lookup} << sources << lock
+//...and may be called by any number of threads at once
+class config_factory
+{
+public:
+    config_factory(
+        const std::string& app_name,
+        const std::vector<config_source>& sources,
+        config::key_lookup lookup = config::case_sensitive);
+    config create(const std::string& instance_name = std::string()) const;
+    std::size_t memory_usage() const;//...bytes of image shared by all created configs
+private:
+    config base_;
+    std::vector<config_source> sources_;
 };
 
 template<typename T>
-inline T config_node::get(const std::string& attr_name) const
+inline T config_view::get(boost::string_ref attr_name) const
 {
-    const std::string value(get(attr_name));
-    try
-    {
-        return boost::lexical_cast<T>(value);
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw_value_conversion_error(attr_name, value);
-    }
+    boost::string_ref value;
+    T result;
+    if( detail::config_value_cast<T>::get(get_value(attr_name, value), result) ||
+        detail::config_value_parser<T>::parse(value, result) )
+        return result;
+    throw_value_conversion_error(attr_name, value);
 }
 
 template<typename T>
-inline boost::optional<T> config_node::get_optional(const std::string& attr_name) const
+inline boost::optional<T> config_view::get_optional(boost::string_ref attr_name) const
 {
-    const boost::optional<std::string> value(get_optional(attr_name));
-    if(!value)
+    boost::string_ref value;
+    const detail::config_value* cached(get_value_optional(attr_name, value));
+    if(!cached)
         return boost::none;
-    try
-    {
-        return boost::lexical_cast<T>(*value);
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw_value_conversion_error(attr_name, *value);
-    }
+    T result;
+    if( detail::config_value_cast<T>::get(*cached, result) ||
+        detail::config_value_parser<T>::parse(value, result) )
+        return result;
+    throw_value_conversion_error(attr_name, value);
 }
 
 template<typename T>
-inline T config_node::get(const std::string& attr_name, const T& default_value) const
+inline T config_view::get(boost::string_ref attr_name, const T& default_value) const
 {
-    boost::optional<std::string> value(get_optional(attr_name));
-    if(!value)
+    boost::string_ref value;
+    const detail::config_value* cached(get_value_optional(attr_name, value));
+    if(!cached)
         return default_value;
-    try
-    {
-        return boost::lexical_cast<T>(*value);
-    }
-    catch(const boost::bad_lexical_cast&)
-    {
-        throw_value_conversion_error(attr_name, *value);
-    }
+    T result;
+    if( detail::config_value_cast<T>::get(*cached, result) ||
+        detail::config_value_parser<T>::parse(value, result) )
+        return result;
+    throw_value_conversion_error(attr_name, value);
+}
+
+template<typename T>
+inline config_key<T> config_view::key(boost::string_ref attr_name) const
+{
+    return config_key<T>{get<T>(attr_name)};
+}
+
+template<typename T>
+inline config_array<T> config_view::get_array(boost::string_ref attr_name) const
+{
+    static_assert(
+        std::is_same<T, std::int64_t>::value || std::is_same<T, double>::value,
+        "elements of array property are stored as std::int64_t or double");
+    const detail::config_array_data data{get_array_data(attr_name)};
+    if(!(data.flags & detail::config_array_cast<T>::flag))
+        throw_array_conversion_error(attr_name, detail::config_array_cast<T>::flag);
+    return config_array<T>{detail::config_array_cast<T>::get(data), data.size};
+}
+
+inline config_view config_node::view() const { return config_view{impl_.get(), tree_node_}; }
+
+inline config_view::config_view(const config_node& node): impl_{node.impl_.get()}, tree_node_{node.tree_node_} {}
+
+template<typename T>
+inline T config_node::get(boost::string_ref attr_name) const { return view().get<T>(attr_name); }
+
+template<typename T>
+inline boost::optional<T> config_node::get_optional(boost::string_ref attr_name) const
+{
+    return view().get_optional<T>(attr_name);
+}
+
+template<typename T>
+inline T config_node::get(boost::string_ref attr_name, const T& default_value) const
+{
+    return view().get<T>(attr_name, default_value);
+}
+
+template<typename T>
+inline config_key<T> config_node::key(boost::string_ref attr_name) const { return view().key<T>(attr_name); }
+
+template<typename T>
+inline config_array<T> config_node::get_array(boost::string_ref attr_name) const
+{
+    return view().get_array<T>(attr_name);
 }
 
 }//namespace jet
@@ -0,0 +1,197 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_CONVERSION_HEADER_GUARD
+#define JET_CONFIG_CONFIG_CONVERSION_HEADER_GUARD
+
+#include <boost/lexical_cast/try_lexical_convert.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+namespace jet
+{
+
+//...amount of memory, property value is number of bytes with optional unit (case doesn't matter):
+//...'B', binary 'K', 'M', 'G', 'T' (the same as 'KiB', 'MiB', 'GiB', 'TiB') or decimal 'KB', 'MB',
+//...'GB', 'TB'. Fraction is allowed if result is whole number of bytes: '64KiB', '2G', '1.5MB'
+class byte_size
+{
+public:
+    constexpr byte_size(): bytes_{} {}
+    constexpr explicit byte_size(std::uint64_t bytes): bytes_{bytes} {}
+    constexpr std::uint64_t count() const { return bytes_; }
+private:
+    std::uint64_t bytes_;
+};
+
+inline bool operator==(byte_size lhs, byte_size rhs) { return lhs.count() == rhs.count(); }
+inline bool operator!=(byte_size lhs, byte_size rhs) { return lhs.count() != rhs.count(); }
+inline bool operator<(byte_size lhs, byte_size rhs) { return lhs.count() < rhs.count(); }
+inline std::ostream& operator<<(std::ostream& os, byte_size size) { return os << size.count() << 'B'; }
+
+namespace detail
+{
+
+template<typename T>
+struct is_config_integer: std::integral_constant<bool,
+    std::is_integral<T>::value &&
+    !std::is_same<T, bool>::value &&
+    !std::is_same<T, char>::value &&
+    !std::is_same<T, signed char>::value &&
+    !std::is_same<T, unsigned char>::value &&
+    !std::is_same<T, wchar_t>::value &&
+    !std::is_same<T, char16_t>::value &&
+    !std::is_same<T, char32_t>::value>
+{};
+
+//...locale-free parsers of property values. Whole text has to be parsed (no spaces around),
+//...false is returned if it can't be or if result doesn't fit
+bool parse_integer(boost::string_ref text, std::int64_t& result);//...[+-]digits
+bool parse_unsigned(boost::string_ref text, std::uint64_t& result);//...[+]digits
+//...decimal number with optional fraction and exponent, result is correctly rounded.
+//...Numbers which can't be converted exactly by fast path (and 'inf', 'nan') go to lexical_cast
+bool parse_floating(boost::string_ref text, double& result);
+bool parse_boolean(boost::string_ref text, bool& result);//...true/yes/on/1 or false/no/off/0, any case
+//...number with optional fraction and unit: 'ns', 'us', 'ms', 's', 'm' or 'min', 'h', 'd' ('250ms', '1.5s')
+bool parse_duration(boost::string_ref text, std::chrono::nanoseconds& result);
+bool parse_byte_size(boost::string_ref text, std::uint64_t& result);//...see byte_size
+
+//...conversion of property text to T when cached representation (config_value_cast) isn't available.
+//...Types without specialization are converted by lexical_cast
+template<typename T, typename enable = void>
+struct config_value_parser
+{
+    static bool parse(boost::string_ref text, T& result)
+    {
+        return boost::conversion::try_lexical_convert(text.data(), text.size(), result);
+    }
+};
+
+template<typename T>
+struct config_value_parser<T, typename std::enable_if<is_config_integer<T>::value && std::is_signed<T>::value>::type>
+{
+    static bool parse(boost::string_ref text, T& result)
+    {
+        std::int64_t value;
+        if( !parse_integer(text, value) ||
+            value < static_cast<std::int64_t>(std::numeric_limits<T>::min()) ||
+            value > static_cast<std::int64_t>(std::numeric_limits<T>::max()) )
+            return false;
+        result = static_cast<T>(value);
+        return true;
+    }
+};
+
+template<typename T>
+struct config_value_parser<T, typename std::enable_if<is_config_integer<T>::value && std::is_unsigned<T>::value>::type>
+{
+    static bool parse(boost::string_ref text, T& result)
+    {
+        std::uint64_t value;
+        if(!parse_unsigned(text, value) || value > static_cast<std::uint64_t>(std::numeric_limits<T>::max()))
+            return false;
+        result = static_cast<T>(value);
+        return true;
+    }
+};
+
+template<>
+struct config_value_parser<double>
+{
+    static bool parse(boost::string_ref text, double& result) { return parse_floating(text, result); }
+};
+
+template<>
+struct config_value_parser<float>
+{
+    static bool parse(boost::string_ref text, float& result)
+    {
+        double value;
+        if(!parse_floating(text, value))
+            return false;
+        const float max{std::numeric_limits<float>::max()};
+        if(std::isfinite(value) && std::fabs(value) > max)
+        {//...value rounds to max unless it's at least halfway between max and the next power of two
+            const int max_exponent{std::numeric_limits<float>::max_exponent};
+            const int digits{std::numeric_limits<float>::digits};
+            if(std::fabs(value) >= std::ldexp(1.0, max_exponent) - std::ldexp(1.0, max_exponent - digits - 1))
+                return false;
+            result = value < 0 ? -max : max;
+            return true;
+        }
+        result = static_cast<float>(value);
+        return true;
+    }
+};
+
+template<>
+struct config_value_parser<bool>
+{
+    static bool parse(boost::string_ref text, bool& result) { return parse_boolean(text, result); }
+};
+
+template<>
+struct config_value_parser<std::string>
+{
+    static bool parse(boost::string_ref text, std::string& result)
+    {
+        result.assign(text.data(), text.size());
+        return true;
+    }
+};
+
+//...number without unit is count of target units, value with unit has to be whole number of them
+template<typename Rep, typename Period>
+struct config_value_parser<std::chrono::duration<Rep, Period>>
+{
+    static_assert(std::is_integral<Rep>::value, "config durations have to be integral");
+    static bool parse(boost::string_ref text, std::chrono::duration<Rep, Period>& result)
+    {
+        using target = std::chrono::duration<std::int64_t, Period>;
+        std::int64_t count;
+        if(!parse_integer(text, count))
+        {
+            std::chrono::nanoseconds value;
+            if(!parse_duration(text, value))
+                return false;
+            const target converted{std::chrono::duration_cast<target>(value)};
+            if(std::chrono::duration_cast<std::chrono::nanoseconds>(converted) != value)
+                return false;
+            count = converted.count();
+        }
+        if( count < static_cast<std::int64_t>(std::numeric_limits<Rep>::min()) ||
+            (count > 0 && static_cast<std::uint64_t>(count) > static_cast<std::uint64_t>(std::numeric_limits<Rep>::max())) )
+            return false;
+        result = std::chrono::duration<Rep, Period>{static_cast<Rep>(count)};
+        return true;
+    }
+};
+
+template<>
+struct config_value_parser<byte_size>
+{
+    static bool parse(boost::string_ref text, byte_size& result)
+    {
+        std::uint64_t bytes;
+        if(!parse_byte_size(text, bytes))
+            return false;
+        result = byte_size{bytes};
+        return true;
+    }
+};
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_CONVERSION_HEADER_GUARD*/
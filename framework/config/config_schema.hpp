@@ -0,0 +1,182 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_SCHEMA_HEADER_GUARD
+#define JET_CONFIG_CONFIG_SCHEMA_HEADER_GUARD
+
+#include "config.hpp"
+#include "config_error.hpp"
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace jet
+{
+
+namespace detail
+{
+void throw_schema_error[[noreturn]](const std::string& node_name, const std::vector<std::string>& errors);
+
+template<typename T>
+inline void print_field_value(std::ostream& os, const T& value)
+{
+    os << value;
+}
+
+template<typename Rep, typename Period>
+inline void print_field_value(std::ostream& os, const std::chrono::duration<Rep, Period>& value)
+{
+    os << std::chrono::duration_cast<std::chrono::duration<double>>(value).count() << 's';
+}
+}//namespace detail
+
+//...typed property of settings struct 'S': path relative to the bound node, member of 'S' which
+//...receives the value, default value (property is required without it) and allowed range.
+//...Field of arithmetic type is a literal type, so it can be declared constexpr:
+//...    constexpr auto threads = jet::make_config_field("threads", &settings::threads).range(1, 64);
+template<typename S, typename T>
+class config_field
+{
+public:
+    using settings_type = S;
+    using value_type = T;
+
+    constexpr config_field(const char* path, T S::* member):
+        config_field{path, member, T{}, false, T{}, T{}, false}
+    {}
+    constexpr config_field default_value(const T& value) const
+    {
+        return config_field{path_, member_, value, true, min_, max_, has_range_};
+    }
+    constexpr config_field range(const T& min, const T& max) const
+    {
+        return config_field{path_, member_, default_, has_default_, min, max, true};
+    }
+    constexpr const char* path() const { return path_; }
+
+    //...violations are added to 'errors', so all of them are reported at once
+    void bind(const config_view& node, S& settings, std::vector<std::string>& errors) const;
+private:
+    constexpr config_field(
+        const char* path,
+        T S::* member,
+        const T& default_value,
+        bool has_default,
+        const T& min,
+        const T& max,
+        bool has_range):
+        path_{path},
+        member_{member},
+        default_{default_value},
+        has_default_{has_default},
+        min_{min},
+        max_{max},
+        has_range_{has_range}
+    {}
+    //...
+    const char* path_;
+    T S::* member_;
+    T default_;
+    bool has_default_;
+    T min_, max_;
+    bool has_range_;
+};
+
+template<typename S, typename T>
+constexpr config_field<S, T> make_config_field(const char* path, T S::* member)
+{
+    return config_field<S, T>{path, member};
+}
+
+//...set of fields which is bound to locked config (or to its node) once, usually right after lock,
+//...so hot code reads plain members of 'S' without any lookup or conversion. bind() throws
+//...config_error which lists every missing, malformed and out of range property
+template<typename S, typename... fields>
+class config_schema
+{
+    static_assert(std::is_default_constructible<S>::value, "settings struct has to be default constructible");
+public:
+    explicit config_schema(const fields&... all): fields_{all...} {}
+    S bind(const config_view& node) const
+    {
+        S settings{};
+        std::vector<std::string> errors;
+        bind_fields<0>(node, settings, errors);
+        if(!errors.empty())
+            detail::throw_schema_error(node.name(), errors);
+        return settings;
+    }
+private:
+    template<std::size_t index>
+    typename std::enable_if<index < sizeof...(fields)>::type bind_fields(
+        const config_view& node,
+        S& settings,
+        std::vector<std::string>& errors) const
+    {
+        std::get<index>(fields_).bind(node, settings, errors);
+        bind_fields<index + 1>(node, settings, errors);
+    }
+    template<std::size_t index>
+    typename std::enable_if<index == sizeof...(fields)>::type bind_fields(
+        const config_view&,
+        S&,
+        std::vector<std::string>&) const
+    {}
+    //...
+    std::tuple<fields...> fields_;
+};
+
+template<typename S, typename... fields>
+config_schema<S, fields...> make_config_schema(const fields&... all)
+{
+    return config_schema<S, fields...>{all...};
+}
+
+template<typename S, typename T>
+void config_field<S, T>::bind(const config_view& node, S& settings, std::vector<std::string>& errors) const
+{
+    T value(default_);
+    if(node.get_node_optional(path_))//...throws if config isn't locked, get() reports intermediate node
+    {
+        try
+        {
+            value = node.get<T>(path_);
+        }
+        catch(const config_error& ex)
+        {
+            errors.push_back(ex.what());
+            return;
+        }
+    }
+    else if(!has_default_)
+    {
+        errors.push_back(std::string{"property '"} + path_ + "' is missing");
+        return;
+    }
+    if(has_range_ && (value < min_ || max_ < value))
+    {
+        std::ostringstream strm;
+        strm << "value ";
+        detail::print_field_value(strm, value);
+        strm << " of property '" << path_ << "' is out of range [";
+        detail::print_field_value(strm, min_);
+        strm << ", ";
+        detail::print_field_value(strm, max_);
+        strm << ']';
+        errors.push_back(strm.str());
+        return;
+    }
+    settings.*member_ = value;
+}
+
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_SCHEMA_HEADER_GUARD*/
@@ -10,8 +10,11 @@
 #define JET_CONFIG_CONFIG_SOURCE_HEADER_GUARD
 
 #include <string>
+#include <cstddef>
 #include <iosfwd>
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace jet
 {
@@ -28,7 +31,7 @@ public:
     struct from_string
     {
         from_string(const std::string& source): source_{source} {}
-        from_string(std::string&& source): source_{source} {}
+        from_string(std::string&& source): source_{std::move(source)} {}
         from_string(const from_string&) = default;
         from_string& operator=(const from_string&) = default;
         from_string(from_string&&) = default;
@@ -82,6 +85,55 @@ public:
         config_source::input_format fmt_ { config_source::xml };
         config_source::file_name_style name_style_ { config_source::case_sensitive };
     };
+    //...parses memory region in place (without copying it into stream), the region has to be
+    //...valid only during create()
+    struct from_buffer
+    {
+        from_buffer(const char* data, std::size_t size): data_(data), size_(size) {}
+        //...
+        from_buffer& name(const std::string& name)
+        {
+            name_ = name;
+            return *this;
+        }
+        from_buffer& input_format(config_source::input_format fmt)
+        {
+            fmt_ = fmt;
+            return *this;
+        }
+        from_buffer& file_name_style(config_source::file_name_style name_style)
+        {
+            name_style_ = name_style;
+            return *this;
+        }
+        config_source create();
+    private:
+        std::string name_{"unknown"};
+        const char* data_;
+        std::size_t size_;
+        config_source::input_format fmt_ { config_source::xml };
+        config_source::file_name_style name_style_ { config_source::case_sensitive };
+    };
+    //...the same as from_file, but file is mapped into memory and parsed from there
+    struct from_mapped_file
+    {
+        from_mapped_file(const std::string& filename): filename_(filename) {}
+        from_mapped_file& input_format(config_source::input_format fmt)
+        {
+            fmt_ = fmt;
+            return *this;
+        }
+        from_mapped_file& file_name_style(config_source::file_name_style name_style)
+        {
+            name_style_ = name_style;
+            return *this;
+        }
+        config_source create();
+    private:
+        std::string filename_;
+        config_source::input_format fmt_ { config_source::xml };
+        config_source::file_name_style name_style_ { config_source::case_sensitive };
+    };
     struct from_file
     {
         from_file(const std::string& filename): filename_(filename) {}
@@ -123,6 +175,8 @@ public:
     explicit config_source(factory_type factory):
         config_source(std::move(factory.create()))
     {}
+    //...parsed tree is immutable and shared by copies: copying is O(1), and source which is merged
+    //...into many configs (e.g. one per instance) is parsed and stored once
     config_source(const config_source& other);
     config_source& operator=(const config_source& other);
     config_source(config_source&& other);
@@ -130,11 +184,32 @@ public:
     ~config_source();
     const std::string& name() const;
     std::string to_string(output_type type = pretty) const;
+    std::size_t memory_usage() const;//...estimated bytes of heap owned by source tree
 private:
-    std::unique_ptr<impl> impl_;
+    std::shared_ptr<const impl> impl_;
     friend class config_node;
 };
 
+//...set of config source factories which are created concurrently:
+//...config << (config_source_batch{} << from_file{"a.xml"} << from_file{"b.xml"}).create();
+class config_source_batch
+{
+public:
+    template<typename factory_type>
+    config_source_batch& operator<<(const factory_type& factory)
+    {
+        factories_.emplace_back([factory]() { return factory_type{factory}.create(); });
+        return *this;
+    }
+    //...sources are parsed on 'threads' threads (hardware concurrency if 0) and returned in the same
+    //...order as factories were added, so merging them gives the same config as sequential parsing.
+    //...If some sources can't be parsed, the error of the first of them is thrown
+    std::vector<config_source> create(std::size_t threads = 0) const;
+    std::size_t size() const { return factories_.size(); }
+private:
+    std::vector<std::function<config_source()>> factories_;
+};
+
 }//namespace jet
 
 #endif /*JET_CONFIG_CONFIG_SOURCE_HEADER_GUARD*/
@@ -8,11 +8,16 @@
 
 #include "config.hpp"
 #include "config_source_impl.hpp"
+#include "config_snapshot.hpp"
+#include "config_child_index.hpp"
 #include "config_throw.hpp"
+#include <boost/noncopyable.hpp>
 #include <boost/property_tree/exceptions.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/algorithm/string.hpp>
+#include <atomic>
 #include <sstream>
+#include <unordered_map>
 
 namespace PT           = boost::property_tree;
 using value_type       = PT::ptree::value_type;
@@ -31,7 +36,7 @@ namespace
 inline std::string compose_name(
     const std::string& app_name,
     const std::string& instance_name = std::string{},
-    const std::string& path = std::string{})
+    boost::string_ref path = boost::string_ref{})
 {
     std::string res{app_name};
     if(!instance_name.empty())
@@ -42,20 +47,163 @@ inline std::string compose_name(
     if(!path.empty())
     {
         res += NODE_DELIMITER;
-        res += path;
+        res.append(path.data(), path.size());
     }
     return res;
 }
 
-inline std::string add_path(const std::string& lhs, const std::string& rhs)
+inline std::string add_path(const std::string& lhs, boost::string_ref rhs)
 {
     std::string res{lhs};
     if(!res.empty() && !rhs.empty())
         res += NODE_DELIMITER;
-    res += rhs;
+    res.append(rhs.data(), rhs.size());
     return res;
 }
 
+inline bool is_space(char c)
+{
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c || '\f' == c || '\v' == c;
+}
+
+inline boost::string_ref trim(boost::string_ref str)
+{//...the same as boost::trim_copy, but without copying
+    while(!str.empty() && is_space(str.front()))
+        str.remove_prefix(1);
+    while(!str.empty() && is_space(str.back()))
+        str.remove_suffix(1);
+    return str;
+}
+
+inline const config_snapshot::node& snapshot_node(const config_snapshot& snapshot, const void* tree_node)
+{//...config itself has no node: it's root of the snapshot, which doesn't exist till config is locked
+    return tree_node ? *static_cast<const config_snapshot::node*>(tree_node) : snapshot.root();
+}
+
+inline const config_snapshot::node& find_property(
+    const config_view& owner,
+    const config_snapshot& snapshot,
+    const void* tree_node,
+    boost::string_ref attr_name)
+{
+    const config_snapshot::node* attr_node{snapshot.find(snapshot_node(snapshot, tree_node), attr_name)};
+    if(!attr_node)
+        JET_THROW_CFG()
+            << "Can't find property '" << attr_name
+            << "' in config '" << owner.name() << '\'';
+    if(attr_node->child_count)
+        JET_THROW_CFG()
+            << "Node '" << add_path(owner.name(), attr_name) << "' is intermidiate node without value";
+    return *attr_node;
+}
+
+inline const config_snapshot::node* find_optional_property(
+    const config_snapshot& snapshot,
+    const void* tree_node,
+    boost::string_ref attr_name)
+{
+    const config_snapshot::node* attr_node{snapshot.find(snapshot_node(snapshot, tree_node), attr_name)};
+    if(attr_node && !attr_node->child_count)
+        return attr_node;
+    return nullptr;
+}
+
+class config_differ: boost::noncopyable
+{
+public:
+    config_differ(const config_snapshot& from, const config_snapshot& to, config_changes& changes):
+        from_(from), to_(to), changes_(changes)
+    {}
+    void diff(const config_snapshot::node* from, const config_snapshot::node* to)
+    {//...either 'from' or 'to' may be null for removed or added subtree. Equal hashes of properties
+     //...are confirmed by their values, subtrees with equal hashes are skipped without visiting them
+        if( from && to && from->subtree_hash == to->subtree_hash &&
+            (from->child_count || to->child_count || from_.value(*from) == to_.value(*to)) )
+            return;
+        const bool from_leaf{from && !from->child_count}, to_leaf{to && !to->child_count};
+        if(from_leaf || to_leaf)
+        {
+            config_change change{path_, boost::none, boost::none};
+            if(from_leaf)
+                change.old_value = from_.value(*from).to_string();
+            if(to_leaf)
+                change.new_value = to_.value(*to).to_string();
+            if(change.old_value != change.new_value)
+                changes_.push_back(std::move(change));
+        }
+        if(from && to && same_names(*from, *to))
+        {//...usual case: the same children in the same order, they are matched one by one
+            const config_snapshot::node* from_child{from_.children_begin(*from)};
+            for(const config_snapshot::node* child = to_.children_begin(*to); to_.children_end(*to) != child; ++child)
+                diff_child(to_.name(*child), from_child++, child);
+            return;
+        }
+        //...k-th child with some name in 'to' is compared with k-th child with the same name in 'from'
+        std::unordered_map<boost::string_ref, std::vector<const config_snapshot::node*>, detail::name_hash> from_children;
+        if(from)
+        {
+            for(const config_snapshot::node* child = from_.children_end(*from); from_.children_begin(*from) != child;)
+            {
+                --child;
+                from_children[from_.name(*child)].push_back(child);
+            }
+        }
+        if(to)
+        {
+            for(const config_snapshot::node* child = to_.children_begin(*to); to_.children_end(*to) != child; ++child)
+            {
+                const config_snapshot::node* from_child{};
+                const auto iter = from_children.find(to_.name(*child));
+                if(from_children.end() != iter && !iter->second.empty())
+                {
+                    from_child = iter->second.back();
+                    iter->second.pop_back();
+                }
+                diff_child(to_.name(*child), from_child, child);
+            }
+        }
+        if(from)
+        {
+            for(const config_snapshot::node* child = from_.children_begin(*from); from_.children_end(*from) != child; ++child)
+            {
+                const auto iter = from_children.find(from_.name(*child));
+                if(!iter->second.empty() && child == iter->second.back())
+                {
+                    iter->second.pop_back();
+                    diff_child(from_.name(*child), child, nullptr);
+                }
+            }
+        }
+    }
+private:
+    bool same_names(const config_snapshot::node& from, const config_snapshot::node& to) const
+    {
+        if(from.child_count != to.child_count)
+            return false;
+        const config_snapshot::node* from_child{from_.children_begin(from)};
+        for(const config_snapshot::node* child = to_.children_begin(to); to_.children_end(to) != child; ++child)
+        {
+            if(!from_.same_name(*from_child++, to_, *child))
+                return false;
+        }
+        return true;
+    }
+    void diff_child(boost::string_ref name, const config_snapshot::node* from, const config_snapshot::node* to)
+    {
+        const size_t path_size{path_.size()};
+        if(!path_.empty())
+            path_ += NODE_DELIMITER;
+        path_.append(name.data(), name.size());
+        diff(from, to);
+        path_.resize(path_size);
+    }
+    //...
+    const config_snapshot& from_;
+    const config_snapshot& to_;
+    config_changes& changes_;
+    std::string path_;
+};
+
 }//anonymous namespace
 
 const config_lock lock{};
@@ -63,9 +211,10 @@ const config_lock lock{};
 class config_node::impl: boost::noncopyable
 {
 public:
-    impl(const std::string& app_name, const std::string& instance_name):
+    impl(const std::string& app_name, const std::string& instance_name, bool ignore_case):
         app_name_{app_name},
         instance_name_{instance_name},
+        ignore_case_{ignore_case},
         is_locked_{false},
         config_{}
     {
@@ -78,11 +227,22 @@ public:
         config_->push_back({app_name_, tree{}});
         config_->push_back({DEFAULT_NODE_NAME, tree{}});
     }
+    explicit impl(std::shared_ptr<const config_snapshot> snapshot)://...locked config restored from image or overlay
+        app_name_{snapshot->app_name().to_string()},
+        instance_name_{snapshot->instance_name().to_string()},
+        ignore_case_{snapshot->ignore_case()},
+        is_locked_{true},
+        config_{},
+        snapshot_{std::move(snapshot)}
+    {
+        if(app_name_.empty())
+            JET_THROW_CFG() << "Empty config name";
+    }
     const std::string& app_name() const { return app_name_; }
     const std::string& instance_name() const { return instance_name_; }
     void merge(const config_source::impl& source)
     {
-        if(is_locked_)
+        if(is_locked())
             JET_THROW_CFG() << "config '" << name() << "' is locked";
         const tree& other_config(source.get_root().front().second);
         
@@ -111,7 +271,7 @@ public:
     }
     void lock()
     {
-        if(is_locked_)
+        if(is_locked())
             return;
         //...merge self node and (optionally) instance node into default node
         merge_processor(ROOT_NODE_NAME NODE_DELIMITER DEFAULT_NODE_NAME, app_name()).merge(
@@ -124,19 +284,69 @@ public:
         //...erase default and (optionally) instance node
         config_->erase(DEFAULT_NODE_NAME);
         config_->erase(instance_name());
-        is_locked_ = true;
+        //...compile the merged tree into flat snapshot, the tree itself is not needed anymore
+        snapshot_.reset(new config_snapshot{config_->front().second, app_name(), instance_name(), ignore_case_});
+        root_.clear();
+        config_ = nullptr;
+        //...publishes the snapshot: reader which sees the config locked sees the whole snapshot
+        is_locked_.store(true, std::memory_order_release);
     }
-    const tree& get_config_node() const
+    //...locked config of instance which shares snapshot of this locked config (built without instance):
+    //...instance nodes of sources are merged into delta and delta is merged into snapshot as overlay.
+    //...Result is the same as of config of instance built from the same sources
+    std::shared_ptr<impl> derive(
+        const std::string& instance_name,
+        const std::vector<config_source>& sources) const
     {
-        if(!is_locked_)
+        assert(is_locked() && this->instance_name().empty());
+        const std::string name{compose_name(app_name(), instance_name)};
+        tree delta;
+        for(const config_source& source : sources)
+        {
+            const tree& other_config(source.impl_->get_root().front().second);
+            const cassoc_tree_iter app_iter{other_config.find(app_name())};
+            if(other_config.not_found() == app_iter)
+                continue;
+            const cassoc_tree_iter instance_root_iter{app_iter->second.find(INSTANCE_NODE_NAME)};
+            if(app_iter->second.not_found() == instance_root_iter)
+                continue;
+            const cassoc_tree_iter instance_iter{instance_root_iter->second.find(instance_name)};
+            if(instance_root_iter->second.not_found() != instance_iter)
+                merge_processor(name, source.impl_->name()).merge(delta, instance_iter->second);
+        }
+        merge_processor(ROOT_NODE_NAME NODE_DELIMITER DEFAULT_NODE_NAME, name).check(
+            *snapshot_, snapshot_->root(), delta);
+        return std::make_shared<impl>(
+            std::make_shared<config_snapshot>(snapshot_, delta, app_name(), instance_name));
+    }
+    const config_snapshot& get_snapshot() const
+    {//...all reads go through here, snapshot is immutable, so readers don't need any other sync
+        if(!is_locked())
             JET_THROW_CFG() << "Initialization of config '" << name() << "' is not finished";
-        return *config_;
+        return *snapshot_;
+    }
+    void save(const std::string& image_filename) const
+    {
+        get_snapshot().save(image_filename);
+    }
+    std::size_t memory_usage() const
+    {
+        return is_locked() ? snapshot_->memory_usage() : tree_memory_usage(root_);
     }
     void print(std::ostream& os) const
     {
-        PT::write_xml(os, root_, PT::xml_writer_make_settings(' ', 2));
+        if(is_locked())
+        {
+            tree root;
+            root.push_back({ROOT_NODE_NAME, tree{}})->second.push_back(
+                {app_name(), snapshot_->to_tree(snapshot_->root())});
+            PT::write_xml(os, root, PT::xml_writer_make_settings(' ', 2));
+        }
+        else
+            PT::write_xml(os, root_, PT::xml_writer_make_settings(' ', 2));
     }
     std::string name() const { return compose_name(app_name(), instance_name()); }
+    bool is_locked() const { return is_locked_.load(std::memory_order_acquire); }
 private:
     class merge_processor
     {
@@ -146,53 +356,71 @@ private:
             source_name_(source_name)
         {}
         void merge(tree& to, const tree& from) const
-        {
-            tree new_children{};
+        {//...new children are appended to 'to' right away, they aren't in the index, so
+         //...repeated nodes of 'from' are all added instead of being merged into each other
+            const detail::child_index from_index{from};
+            const detail::basic_child_index<tree> to_index{to};
             for(const value_type& node: from)
             {
                 const std::string& merge_name{node.first};
                 if(INSTANCE_NODE_NAME == merge_name)
                     continue;
-                {//...check for ambiguous merge
-                    const size_t from_count { from.count(merge_name) };
-                    const size_t to_count { to.count(merge_name) };
-                    if( (from_count > 0 && to_count > 1) ||
-                        (to_count > 0 && from_count > 1) )
-                        JET_THROW_CFG()
-                            << "Can't do ambiguous merge of node '" << merge_name
-                            << "' from config source '" << source_name_
-                            << "' to config '" << config_name_<< '\'';
-                }
+                check_ambiguity(merge_name, from_index.count(merge_name), to_index.count(merge_name));
                 const tree& merge_tree { node.second };
-                const assoc_tree_iter iter { to.find(merge_name) };
-                if(iter == to.not_found())
+                tree* const to_tree { to_index.find(merge_name) };
+                if(!to_tree)
                 {
-                    new_children.push_back(node);
+                    to.push_back(node);
                 }
                 else if(merge_tree.empty())
                 {
-                    iter->second = merge_tree;
+                    *to_tree = merge_tree;
                 }
                 else
                 {
-                    merge(iter->second, merge_tree);
+                    merge(*to_tree, merge_tree);
                 }
             }
-            for(value_type& node: new_children)
+        }
+        //...the same checks as merge() does, but 'to' is node of locked config, which isn't changed
+        void check(const config_snapshot& snapshot, const config_snapshot::node& to, const tree& from) const
+        {
+            const detail::child_index from_index{from};
+            std::unordered_map<boost::string_ref, std::pair<size_t, const config_snapshot::node*>, detail::name_hash> to_index;
+            for(const config_snapshot::node* child = snapshot.children_begin(to); snapshot.children_end(to) != child; ++child)
             {
-                const std::string& name{node.first};
-                to.push_back({name, tree{}});
-                node.second.swap(to.back().second);
+                auto& entry = to_index[snapshot.name(*child)];
+                if(!entry.first++)
+                    entry.second = child;
+            }
+            for(const value_type& node: from)
+            {
+                const std::string& merge_name{node.first};
+                if(INSTANCE_NODE_NAME == merge_name)
+                    continue;
+                const auto to_iter = to_index.find(merge_name);
+                const size_t to_count{to_index.end() == to_iter ? 0 : to_iter->second.first};
+                check_ambiguity(merge_name, from_index.count(merge_name), to_count);
+                if(to_count && !node.second.empty())
+                    check(snapshot, *to_iter->second.second, node.second);
             }
-
         }
     private:
+        void check_ambiguity(const std::string& merge_name, size_t from_count, size_t to_count) const
+        {
+            if( (from_count > 0 && to_count > 1) ||
+                (to_count > 0 && from_count > 1) )
+                JET_THROW_CFG()
+                    << "Can't do ambiguous merge of node '" << merge_name
+                    << "' from config source '" << source_name_
+                    << "' to config '" << config_name_<< '\'';
+        }
         const std::string config_name_;
         const std::string& source_name_;
     };
     tree& getInstanceNode()
     {
-        assert(!is_locked_);
+        assert(!is_locked());
         assert(!instance_name().empty());
         assert(config_->size() == 3);
         tree& instance{config_->front().second};
@@ -200,7 +428,7 @@ private:
     }
     tree& get_self_node()
     {
-        assert(!is_locked_);
+        assert(!is_locked());
         if(instance_name().empty())
         {
             assert(config_->size() == 2);
@@ -218,34 +446,40 @@ private:
     }
     tree& get_default_node()
     {
-        assert(!is_locked_);
+        assert(!is_locked());
         tree& default_node{config_->back().second};
         return default_node;
     }
     //...
     const std::string app_name_, instance_name_;
-    bool is_locked_;
+    const bool ignore_case_;
+    std::atomic<bool> is_locked_;
     tree root_;
     tree* config_;
+    std::shared_ptr<const config_snapshot> snapshot_;
 };
 
-config_node::config_node(const std::string& app_name, const std::string& instance_name):
-    impl_{std::make_shared<impl>(boost::trim_copy(app_name), boost::trim_copy(instance_name))},
+config_node::config_node(const std::string& app_name, const std::string& instance_name, bool ignore_case):
+    impl_{std::make_shared<impl>(boost::trim_copy(app_name), boost::trim_copy(instance_name), ignore_case)},
+    tree_node_{}
+{}
+
+config_node::config_node(const config_image& image) try:
+    impl_{std::make_shared<impl>(std::make_shared<config_snapshot>(image.filename()))},
     tree_node_{}
 {}
+catch(const std::exception& ex)
+{
+    JET_THROW_CFG() << "Couldn't open config image '" << image.filename() << '\'';
+}
 
-config_node::config_node(
-    const std::string& path,
-    const std::shared_ptr<impl>& impl,
-    const void* tree_node):
-    path_{path},
+config_node::config_node(const std::shared_ptr<impl>& impl, const void* tree_node):
     impl_{impl},
     tree_node_{tree_node}
 {
 }
 
 config_node::config_node(const config_node& other):
-    path_{other.path_},
     impl_{other.impl_},
     tree_node_{other.tree_node_}
 {
@@ -262,179 +496,352 @@ config_node& config_node::operator=(const config_node& other)
 
 config_node::~config_node() {}
 
-std::string config_node::name() const { return compose_name(app_name(), instance_name(), path()); }
+std::string config_node::name() const { return view().name(); }
 
 const std::string& config_node::app_name() const { return impl_->app_name(); }
 
 const std::string& config_node::instance_name() const { return impl_->instance_name(); }
 
+std::string config_node::path() const { return view().path(); }
+
+std::string config_node::node_name() const { return view().node_name(); }
+
+boost::string_ref config_node::path_view() const { return view().path_view(); }
+
+boost::string_ref config_node::node_name_view() const { return view().node_name_view(); }
+
 void config_node::merge(const config_source& source)
 {
     impl_->merge(*source.impl_);
 }
 
 void config_node::lock()
-{
+{//...config keeps null node (it's resolved to the root of snapshot), so lock doesn't modify config
+ //...object itself and readers which race with it don't race with the writer
     impl_->lock();
-    tree_node_ = static_cast<const tree*>(&(impl_->get_config_node().front().second));
+}
+
+void config_node::save(const config_image& image) const
+{
+    impl_->save(image.filename());
+}
+
+std::size_t config_node::memory_usage() const
+{
+    return impl_->memory_usage();
 }
 
 void config_node::print(std::ostream& os) const
 {
-    if(tree_node_)
-    {
-        os << '<' << name() << '>';
-        if(!static_cast<const tree*>(tree_node_)->empty())
-            os << '\n';
-        {
-            std::stringstream strm;
-            PT::write_xml(
-                strm,
-                *static_cast<const tree*>(tree_node_),
-                PT::xml_writer_make_settings(' ', 2));
-            std::string firstString;
-            std::getline(strm, firstString);
-            if(firstString.size() > 2 && //...get rid of the first line with <?xml ...?>
-                '<' == firstString[0] && '?' == firstString[1])
-                os << strm.str().substr(firstString.size() + 1);
-            else
-                os << strm.str();
-        }
-        os << "</" << name() << ">\n";
-    }
+    if(tree_node_ || impl_->is_locked())
+        os << view();
     else
         impl_->print(os);
 }
 
+std::string config_node::get(boost::string_ref attr_name) const { return view().get(attr_name); }
 
-std::string config_node::get(const std::string& raw_attr_name) const
+boost::optional<std::string> config_node::get_optional(boost::string_ref attr_name) const
 {
-    impl_->get_config_node();//...just to check locked state
-    const std::string attr_name{boost::trim_copy(raw_attr_name)};
-    const boost::optional<const tree&> attr_node{
-        static_cast<const tree*>(tree_node_)->get_child_optional(attr_name)};
-    if(!attr_node)
-        JET_THROW_CFG()
-            << "Can't find property '" << attr_name
-            << "' in config '" << name() << '\'';
-    if(attr_node->empty())
-        return attr_node->data();
-    JET_THROW_CFG()
-        << "Node '" << add_path(name(), attr_name) << "' is intermidiate node without value";
+    return view().get_optional(attr_name);
+}
+
+std::string config_node::get(boost::string_ref attr_name, const std::string& default_value) const
+{
+    return view().get(attr_name, default_value);
+}
+
+boost::string_ref config_node::get_view(boost::string_ref attr_name) const { return view().get_view(attr_name); }
+
+boost::optional<boost::string_ref> config_node::get_view_optional(boost::string_ref attr_name) const
+{
+    return view().get_view_optional(attr_name);
+}
+
+config_node config_node::get_node(boost::string_ref path) const
+{
+    return config_node{impl_, view().get_node(path).tree_node_};
+}
+
+boost::optional<config_node> config_node::get_node_optional(boost::string_ref path) const
+{
+    const boost::optional<config_view> node{view().get_node_optional(path)};
+    if(node)
+        return config_node{impl_, node->tree_node_};
+    return boost::none;
+}
+
+std::vector<config_node> config_node::get_children_of(boost::string_ref parent_path) const
+{
+    const config_children children{children_of(parent_path)};
+    return std::vector<config_node>(children.begin(), children.end());
+}
+
+config_children config_node::children_of(boost::string_ref parent_path) const
+{
+    const config_view_children children{view().children_of(parent_path)};
+    return config_children{config_node{impl_, children.first_.tree_node_}, children.size()};
+}
+
+std::ostream& operator<<(std::ostream& os, const config_node& config)
+{
+    config.print(os);
+    return os;
+}
+
+config& config::operator<<(const config_source& source)
+{
+    merge(source);
+    return *this;
 }
 
-boost::optional<std::string> config_node::get_optional(const std::string& attr_name) const
+config& config::operator<<(const std::vector<config_source>& sources)
 {
-    impl_->get_config_node();//...just to check locked state
-    const boost::optional<const tree&> attr_node{
-        static_cast<const tree*>(tree_node_)->get_child_optional(boost::trim_copy(attr_name))};
+    for(const config_source& source : sources)
+        merge(source);
+    return *this;
+}
+
+void config::operator<<(config_lock)
+{
+    lock();
+}
 
-    if(attr_node && attr_node->empty())
-        return attr_node->data();
+std::string config_view::name() const { return compose_name(app_name(), instance_name(), path_view()); }
 
+const std::string& config_view::app_name() const { return impl_->app_name(); }
+
+const std::string& config_view::instance_name() const { return impl_->instance_name(); }
+
+std::string config_view::path() const { return path_view().to_string(); }
+
+std::string config_view::node_name() const { return node_name_view().to_string(); }
+
+boost::string_ref config_view::path_view() const
+{//...config itself is the root, it has empty path even before it's locked
+    if(!tree_node_)
+        return boost::string_ref{};
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    return snapshot.path(snapshot_node(snapshot, tree_node_));
+}
+
+boost::string_ref config_view::node_name_view() const
+{
+    if(!tree_node_)
+        return boost::string_ref{};
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    return snapshot.name(snapshot_node(snapshot, tree_node_));
+}
+
+std::string config_view::get(boost::string_ref attr_name) const
+{
+    return get_view(attr_name).to_string();
+}
+
+boost::optional<std::string> config_view::get_optional(boost::string_ref attr_name) const
+{
+    const boost::optional<boost::string_ref> value{get_view_optional(attr_name)};
+    if(value)
+        return value->to_string();
     return boost::none;
 }
 
-std::string config_node::get(const std::string& attr_name, const std::string& default_value) const
+std::string config_view::get(boost::string_ref attr_name, const std::string& default_value) const
 {
-    const boost::optional<std::string> value{get_optional(attr_name)};
+    const boost::optional<boost::string_ref> value{get_view_optional(attr_name)};
     if(value)
-        return *value;
+        return value->to_string();
     return default_value;
 }
 
-config_node config_node::get_node(const std::string& path) const
+boost::string_ref config_view::get_view(boost::string_ref attr_name) const
+{
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    return snapshot.value(find_property(*this, snapshot, tree_node_, trim(attr_name)));
+}
+
+boost::optional<boost::string_ref> config_view::get_view_optional(boost::string_ref attr_name) const
+{
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const config_snapshot::node* attr_node{find_optional_property(snapshot, tree_node_, trim(attr_name))};
+    if(attr_node)
+        return snapshot.value(*attr_node);
+    return boost::none;
+}
+
+const detail::config_value& config_view::get_value(boost::string_ref attr_name, boost::string_ref& text) const
+{
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const config_snapshot::node& attr_node{find_property(*this, snapshot, tree_node_, trim(attr_name))};
+    text = snapshot.value(attr_node);
+    return attr_node.typed;
+}
+
+const detail::config_value* config_view::get_value_optional(boost::string_ref attr_name, boost::string_ref& text) const
+{
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const config_snapshot::node* attr_node{find_optional_property(snapshot, tree_node_, trim(attr_name))};
+    if(!attr_node)
+        return nullptr;
+    text = snapshot.value(*attr_node);
+    return &attr_node->typed;
+}
+
+config_view config_view::get_node(boost::string_ref path) const
 {
-    boost::optional<config_node> optChild{get_node_optional(path)};
+    boost::optional<config_view> optChild{get_node_optional(path)};
     if(optChild)
         return *optChild;
     JET_THROW_CFG() << "config '" << name() << "' doesn't have child '" << path << '\'';
 }
 
-boost::optional<config_node> config_node::get_node_optional(const std::string& raw_path) const
+boost::optional<config_view> config_view::get_node_optional(boost::string_ref path) const
 {
-    impl_->get_config_node();//...just to check locked state
-    const std::string path{boost::trim_copy(raw_path)};
-    const boost::optional<const tree&> node{
-        static_cast<const tree*>(tree_node_)->get_child_optional(path)};
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const config_snapshot::node* node{snapshot.find(snapshot_node(snapshot, tree_node_), trim(path))};
     if(node)
-    {
-        return config_node{
-            add_path(path_, path),
-            impl_,
-            &(*node)};
-    }
+        return config_view{impl_, node};
     return boost::none;
 }
 
-namespace {
-inline std::pair<std::string, std::string> cutoff_last_node(const std::string& path)
+config_view_children config_view::children_of(boost::string_ref raw_parent_path) const
 {
-    const size_t pos { path.find_last_of(NODE_DELIMITER) };
-    if(pos == std::string::npos)
-        return {std::string{}, path};
-    std::pair<std::string, std::string> res;
-    res.first = path.substr(0, pos);
-    res.second = path.substr(pos + sizeof(NODE_DELIMITER) - 1);
-    return res;
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const boost::string_ref parent_path{trim(raw_parent_path)};
+    const config_snapshot::node* parent_node{snapshot.find(snapshot_node(snapshot, tree_node_), parent_path)};
+    if(!parent_node)
+        JET_THROW_CFG() << "config '" << name() << "' doesn't have child '" << parent_path << '\'';
+    return config_view_children{
+        config_view{impl_, snapshot.children_begin(*parent_node)},
+        parent_node->child_count};
 }
-}//anonymous namespace
 
-const std::string config_node::node_name() const
+std::ostream& operator<<(std::ostream& os, const config_view& config)
 {
-    return cutoff_last_node(path()).second;
+    const config_snapshot& snapshot{config.impl_->get_snapshot()};
+    const config_snapshot::node& node{snapshot_node(snapshot, config.tree_node_)};
+    os << '<' << config.name() << '>';
+    if(node.child_count)
+        os << '\n';
+    {
+        std::stringstream strm;
+        PT::write_xml(
+            strm,
+            snapshot.to_tree(node),
+            PT::xml_writer_make_settings(' ', 2));
+        std::string firstString;
+        std::getline(strm, firstString);
+        if(firstString.size() > 2 && //...get rid of the first line with <?xml ...?>
+            '<' == firstString[0] && '?' == firstString[1])
+            os << strm.str().substr(firstString.size() + 1);
+        else
+            os << strm.str();
+    }
+    os << "</" << config.name() << ">\n";
+    return os;
 }
 
-std::vector<config_node> config_node::get_children_of(const std::string& raw_parent_path) const
+void config_view::throw_value_conversion_error(boost::string_ref attr_name, boost::string_ref value) const
 {
-    impl_->get_config_node();//...just to check locked state
-    
-    const std::string parent_path{boost::trim_copy(raw_parent_path)};
+    JET_THROW_CFG()
+        << "Can't convert value '" << value
+        << "' of a property '" << attr_name
+        << "' in config '" << name() << '\'';
+}
 
-    const std::string full_parent_path(add_path(path_, parent_path));
+detail::config_array_data config_view::get_array_data(boost::string_ref attr_name) const
+{
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    return snapshot.array_of(find_property(*this, snapshot, tree_node_, trim(attr_name)));
+}
 
-    const tree& parent_node = static_cast<const tree*>(tree_node_)->get_child(parent_path);
-    std::vector<config_node> result;
-    for(const auto& node: parent_node)
+void config_view::throw_array_conversion_error(boost::string_ref attr_name, std::uint32_t flag) const
+{//...elements are converted again to find the first one which can't be
+    const config_snapshot& snapshot{impl_->get_snapshot()};
+    const config_snapshot::node& attr_node{find_property(*this, snapshot, tree_node_, trim(attr_name))};
+    const detail::config_array_data data{snapshot.array_of(attr_node)};
+    for(std::size_t index = 0; index < data.size; ++index)
     {
-        const std::string new_path{add_path(full_parent_path, node.first)};
-        result.push_back(
-            config_node{
-                new_path,
-                impl_,
-                &node.second});
+        const boost::string_ref element{snapshot.array_element(attr_node, static_cast<config_snapshot::index_type>(index))};
+        std::int64_t integer;
+        double floating;
+        if( detail::config_value::integer_flag == flag ?
+            !detail::parse_integer(element, integer) :
+            !detail::parse_floating(element, floating) )
+            JET_THROW_CFG()
+                << "Can't convert element " << index << " '" << element
+                << "' of an array property '" << attr_name
+                << "' in config '" << name() << '\'';
     }
-    return result;
+    throw_value_conversion_error(attr_name, snapshot.value(attr_node));
 }
 
-std::ostream& operator<<(std::ostream& os, const config_node& config)
+const void* detail::next_config_node(const void* tree_node, std::size_t distance)
 {
-    config.print(os);
-    return os;
+    return static_cast<const config_snapshot::node*>(tree_node) + distance;
 }
 
-config& config::operator<<(const config_source& source)
+config::config(const std::string& app_name, const std::string& instance_name, key_lookup lookup):
+    config_node(app_name, instance_name, case_insensitive == lookup)
 {
-    merge(source);
-    return *this;
 }
 
-void config::operator<<(config_lock)
+config::config(const config_image& image):
+    config_node(image)
 {
-    lock();
 }
 
-void config_node::throw_value_conversion_error(const std::string& attr_name, const std::string& value) const
+config::config(const std::shared_ptr<impl>& impl):
+    config_node(impl, nullptr)
 {
-    JET_THROW_CFG()
-        << "Can't convert value '" << value
-        << "' of a property '" << attr_name
-        << "' in config '" << name() << '\'';
 }
 
-config::config(const std::string& app_name, const std::string& instance_name):
-    config_node(app_name, instance_name)
+void config::save(const config_image& image) const
+{
+    config_node::save(image);
+}
+
+std::size_t config::memory_usage() const
+{
+    return config_node::memory_usage();
+}
+
+std::size_t config::key_memory_usage()
+{
+    return detail::symbol_table::instance().memory_usage();
+}
+
+config_factory::config_factory(
+    const std::string& app_name,
+    const std::vector<config_source>& sources,
+    config::key_lookup lookup):
+    base_{app_name, std::string(), lookup},
+    sources_{sources}
+{
+    base_ << sources_ << lock;
+}
+
+config config_factory::create(const std::string& instance_name) const
+{
+    const std::string name{boost::trim_copy(instance_name)};
+    if(name.empty())
+        return base_;
+    return config{base_.impl_->derive(name, sources_)};
+}
+
+std::size_t config_factory::memory_usage() const
+{
+    return base_.memory_usage();
+}
+
+config_changes diff(const config_view& from, const config_view& to)
 {
+    config_changes changes;
+    const config_snapshot& from_snapshot{from.impl_->get_snapshot()};
+    const config_snapshot& to_snapshot{to.impl_->get_snapshot()};
+    config_differ{from_snapshot, to_snapshot, changes}.diff(
+        &snapshot_node(from_snapshot, from.tree_node_), &snapshot_node(to_snapshot, to.tree_node_));
+    return changes;
 }
 
 } //namespace jet
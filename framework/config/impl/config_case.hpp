@@ -0,0 +1,102 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_CASE_HEADER_GUARD
+#define JET_CONFIG_CONFIG_CASE_HEADER_GUARD
+
+#include <boost/utility/string_ref.hpp>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace jet
+{
+namespace detail
+{
+
+//...ASCII case folding, it's the same as boost::to_lower with classic locale (the default one),
+//...but it doesn't copy strings and processes long strings by 8 bytes at a time
+
+inline char to_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+//...0x20 in every byte of 'word' which is upper case ASCII letter, so 'word | mask' is in lower case
+inline std::uint64_t upper_case_mask(std::uint64_t word)
+{
+    const std::uint64_t ones{0x0101010101010101ull};
+    const std::uint64_t heptets{word & (0x7F * ones)};
+    const std::uint64_t above_z{heptets + (0x7F - 'Z') * ones};
+    const std::uint64_t from_a{heptets + (0x80 - 'A') * ones};
+    return (~word & (from_a ^ above_z) & (0x80 * ones)) >> 2;
+}
+
+inline std::uint64_t load_word(const char* data)
+{
+    std::uint64_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+inline bool has_upper_case(boost::string_ref str)
+{
+    const char* data{str.data()};
+    const char* const end{data + str.size()};
+    for(; end - data >= 8; data += 8)
+    {
+        if(upper_case_mask(load_word(data)))
+            return true;
+    }
+    for(; end != data; ++data)
+    {
+        if(*data >= 'A' && *data <= 'Z')
+            return true;
+    }
+    return false;
+}
+
+inline void to_lower(std::string& str)
+{
+    char* data{&str[0]};
+    char* const end{data + str.size()};
+    for(; end - data >= 8; data += 8)
+    {
+        const std::uint64_t word{load_word(data)};
+        const std::uint64_t lower{word | upper_case_mask(word)};
+        std::memcpy(data, &lower, sizeof(lower));
+    }
+    for(; end != data; ++data)
+        *data = to_lower(*data);
+}
+
+inline bool iequals(boost::string_ref lhs, boost::string_ref rhs)
+{
+    if(lhs.size() != rhs.size())
+        return false;
+    const char* left{lhs.data()};
+    const char* right{rhs.data()};
+    const char* const end{left + lhs.size()};
+    for(; end - left >= 8; left += 8, right += 8)
+    {
+        const std::uint64_t left_word{load_word(left)}, right_word{load_word(right)};
+        if((left_word | upper_case_mask(left_word)) != (right_word | upper_case_mask(right_word)))
+            return false;
+    }
+    for(; end != left; ++left, ++right)
+    {
+        if(to_lower(*left) != to_lower(*right))
+            return false;
+    }
+    return true;
+}
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_CASE_HEADER_GUARD*/
@@ -0,0 +1,91 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_CHILD_INDEX_HEADER_GUARD
+#define JET_CONFIG_CONFIG_CHILD_INDEX_HEADER_GUARD
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <boost/noncopyable.hpp>
+#include <unordered_map>
+
+namespace jet
+{
+namespace detail
+{
+
+struct name_hash
+{
+    std::size_t operator()(boost::string_ref name) const { return boost::hash_range(name.begin(), name.end()); }
+};
+
+//...children of tree node hashed by name: number of children with the name and the first of them.
+//...Narrow nodes are just scanned, hashing doesn't pay off for them.
+//...Index refers to names of children, so it's valid until children are erased
+template<typename tree_type>
+class basic_child_index: boost::noncopyable
+{
+public:
+    explicit basic_child_index(tree_type& parent): parent_(parent), size_{parent.size()}
+    {
+        if(size_ <= max_scan_size)
+            return;
+        index_.reserve(size_);
+        for(auto& child : parent)
+        {
+            entry& found(index_[child.first]);
+            if(!found.count++)
+                found.first = &child.second;
+        }
+    }
+    std::size_t count(boost::string_ref name) const
+    {
+        if(size_ <= max_scan_size)
+        {
+            std::size_t result{};
+            auto child = parent_.begin();
+            for(std::size_t i = 0; i < size_; ++i, ++child)
+                if(name == child->first)
+                    ++result;
+            return result;
+        }
+        const auto iter = index_.find(name);
+        return index_.end() == iter ? 0 : iter->second.count;
+    }
+    tree_type* find(boost::string_ref name) const
+    {
+        if(size_ <= max_scan_size)
+        {
+            auto child = parent_.begin();
+            for(std::size_t i = 0; i < size_; ++i, ++child)
+                if(name == child->first)
+                    return &child->second;
+            return nullptr;
+        }
+        const auto iter = index_.find(name);
+        return index_.end() == iter ? nullptr : iter->second.first;
+    }
+private:
+    static const std::size_t max_scan_size{8};
+    struct entry
+    {
+        std::size_t count;
+        tree_type* first;
+    };
+    tree_type& parent_;
+    const std::size_t size_;//...children appended after indexing are not in the index
+    std::unordered_map<boost::string_ref, entry, name_hash> index_;
+};
+
+using child_index = basic_child_index<const boost::property_tree::ptree>;
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_CHILD_INDEX_HEADER_GUARD*/
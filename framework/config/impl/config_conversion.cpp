@@ -0,0 +1,284 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_conversion.hpp"
+#include "config_case.hpp"
+
+namespace jet
+{
+namespace detail
+{
+
+namespace
+{
+
+inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+
+//...digits from 'pos' are accumulated into 'result', returns false on overflow
+bool parse_digits(const char*& pos, const char* end, std::uint64_t& result)
+{
+    const std::uint64_t max{std::numeric_limits<std::uint64_t>::max()};
+    result = 0;
+    for(; end != pos && is_digit(*pos); ++pos)
+    {
+        const unsigned digit = *pos - '0';
+        if(result > (max - digit) / 10)
+            return false;
+        result = result * 10 + digit;
+    }
+    return true;
+}
+
+inline bool parse_sign(const char*& pos, const char* end)
+{//...returns true for '-'
+    if(end != pos && ('+' == *pos || '-' == *pos))
+        return '-' == *pos++;
+    return false;
+}
+
+//...'whole' and 'fraction' digits multiplied by 'unit', result has to be whole number which fits into int64
+bool scale(std::uint64_t whole, boost::string_ref fraction, std::uint64_t unit, std::uint64_t& result)
+{
+    const std::uint64_t max{static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())};
+    while(!fraction.empty() && '0' == fraction.back())
+        fraction.remove_suffix(1);
+    if(fraction.size() > 9 || (whole && unit > max / whole))
+        return false;
+    result = whole * unit;
+    if(fraction.empty())
+        return true;
+    std::uint64_t numerator{}, denominator{1};
+    for(const char c : fraction)
+    {
+        numerator = numerator * 10 + static_cast<unsigned>(c - '0');
+        denominator *= 10;
+    }
+    if(unit > max / numerator || (numerator * unit) % denominator)
+        return false;
+    const std::uint64_t part{numerator * unit / denominator};
+    if(result > max - part)
+        return false;
+    result += part;
+    return true;
+}
+
+//...splits text into number (with optional fraction) and unit, spaces between them are allowed
+bool split_quantity(
+    boost::string_ref text,
+    std::uint64_t& whole,
+    boost::string_ref& fraction,
+    boost::string_ref& unit)
+{
+    const char* pos{text.data()};
+    const char* const end{text.data() + text.size()};
+    const char* const whole_begin{pos};
+    if(!parse_digits(pos, end, whole))
+        return false;
+    const bool has_whole{whole_begin != pos};
+    fraction.clear();
+    if(end != pos && '.' == *pos)
+    {
+        const char* const fraction_begin{++pos};
+        while(end != pos && is_digit(*pos))
+            ++pos;
+        fraction = boost::string_ref{fraction_begin, static_cast<size_t>(pos - fraction_begin)};
+    }
+    if(!has_whole && fraction.empty())
+        return false;
+    while(end != pos && ' ' == *pos)
+        ++pos;
+    unit = boost::string_ref{pos, static_cast<size_t>(end - pos)};
+    return true;
+}
+
+//...powers of ten which are exact doubles
+const double exact_powers_of_ten[]
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+}//anonymous namespace
+
+bool parse_unsigned(boost::string_ref text, std::uint64_t& result)
+{
+    const char* pos{text.data()};
+    const char* const end{text.data() + text.size()};
+    if(end != pos && '+' == *pos)
+        ++pos;
+    const char* const digits{pos};
+    return parse_digits(pos, end, result) && digits != pos && end == pos;
+}
+
+bool parse_integer(boost::string_ref text, std::int64_t& result)
+{
+    const char* pos{text.data()};
+    const char* const end{text.data() + text.size()};
+    const bool negative{parse_sign(pos, end)};
+    const char* const digits{pos};
+    std::uint64_t value;
+    if(!parse_digits(pos, end, value) || digits == pos || end != pos)
+        return false;
+    const std::uint64_t max{static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())};
+    if(value > max + (negative ? 1 : 0))
+        return false;
+    result = negative ? static_cast<std::int64_t>(0 - value) : static_cast<std::int64_t>(value);
+    return true;
+}
+
+bool parse_floating(boost::string_ref text, double& result)
+{//...fast path: when significant digits fit into 53 bits and power of ten is exact double, one
+ //...multiplication or division gives correctly rounded result (Clinger's algorithm)
+    const char* pos{text.data()};
+    const char* const end{text.data() + text.size()};
+    const bool negative{parse_sign(pos, end)};
+    if(end != pos && ('i' == *pos || 'I' == *pos || 'n' == *pos || 'N' == *pos))
+        return boost::conversion::try_lexical_convert(text.data(), text.size(), result);
+    const std::uint64_t max_mantissa{std::uint64_t{1} << 53};
+    std::uint64_t mantissa{};
+    int exponent{};
+    bool has_digits{false}, exact{true};
+    for(; end != pos && is_digit(*pos); ++pos)
+    {
+        has_digits = true;
+        if(mantissa < max_mantissa / 10)
+            mantissa = mantissa * 10 + static_cast<unsigned>(*pos - '0');
+        else
+        {
+            exact = exact && '0' == *pos;
+            ++exponent;
+        }
+    }
+    if(end != pos && '.' == *pos)
+    {
+        for(++pos; end != pos && is_digit(*pos); ++pos)
+        {
+            has_digits = true;
+            if(mantissa < max_mantissa / 10)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*pos - '0');
+                --exponent;
+            }
+            else
+                exact = exact && '0' == *pos;
+        }
+    }
+    if(!has_digits)
+        return false;
+    if(end != pos && ('e' == *pos || 'E' == *pos))
+    {
+        ++pos;
+        const bool negative_exponent{parse_sign(pos, end)};
+        const char* const digits{pos};
+        std::uint64_t value;
+        if(!parse_digits(pos, end, value) || digits == pos)
+            return false;
+        if(value > 100000)
+            exact = false;
+        else
+            exponent += negative_exponent ? -static_cast<int>(value) : static_cast<int>(value);
+    }
+    if(end != pos)
+        return false;
+    if(!exact || exponent < -22 || exponent > 22)
+        return boost::conversion::try_lexical_convert(text.data(), text.size(), result);
+    double value{static_cast<double>(mantissa)};
+    if(exponent < 0)
+        value /= exact_powers_of_ten[-exponent];
+    else
+        value *= exact_powers_of_ten[exponent];
+    result = negative ? -value : value;
+    return true;
+}
+
+bool parse_boolean(boost::string_ref text, bool& result)
+{
+    static const char* const true_values[]{"true", "yes", "on", "1"};
+    static const char* const false_values[]{"false", "no", "off", "0"};
+    for(const char* value : true_values)
+    {
+        if(iequals(text, value))
+        {
+            result = true;
+            return true;
+        }
+    }
+    for(const char* value : false_values)
+    {
+        if(iequals(text, value))
+        {
+            result = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_duration(boost::string_ref text, std::chrono::nanoseconds& result)
+{
+    struct unit_info
+    {
+        const char* name;
+        std::uint64_t nanoseconds;
+    };
+    static const unit_info units[]
+    {
+        {"ns", 1}, {"us", 1000}, {"ms", 1000000}, {"s", 1000000000},
+        {"m", 60000000000}, {"min", 60000000000}, {"h", 3600000000000}, {"d", 86400000000000}
+    };
+    const char* pos{text.data()};
+    const char* const end{text.data() + text.size()};
+    const bool negative{parse_sign(pos, end)};
+    std::uint64_t whole;
+    boost::string_ref fraction, unit;
+    if(!split_quantity(boost::string_ref{pos, static_cast<size_t>(end - pos)}, whole, fraction, unit))
+        return false;
+    for(const unit_info& info : units)
+    {
+        std::uint64_t value;
+        if(unit == info.name)
+        {
+            if(!scale(whole, fraction, info.nanoseconds, value))
+                return false;
+            const std::int64_t count{static_cast<std::int64_t>(value)};
+            result = std::chrono::nanoseconds{negative ? -count : count};
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parse_byte_size(boost::string_ref text, std::uint64_t& result)
+{
+    struct unit_info
+    {
+        const char* name;
+        std::uint64_t bytes;
+    };
+    static const unit_info units[]
+    {
+        {"", 1}, {"b", 1},
+        {"k", std::uint64_t{1} << 10}, {"kib", std::uint64_t{1} << 10}, {"kb", 1000},
+        {"m", std::uint64_t{1} << 20}, {"mib", std::uint64_t{1} << 20}, {"mb", 1000000},
+        {"g", std::uint64_t{1} << 30}, {"gib", std::uint64_t{1} << 30}, {"gb", 1000000000},
+        {"t", std::uint64_t{1} << 40}, {"tib", std::uint64_t{1} << 40}, {"tb", 1000000000000}
+    };
+    std::uint64_t whole;
+    boost::string_ref fraction, unit;
+    if(!split_quantity(text, whole, fraction, unit))
+        return false;
+    for(const unit_info& info : units)
+    {
+        if(iequals(unit, info.name))
+            return scale(whole, fraction, info.bytes, result);
+    }
+    return false;
+}
+
+}//namespace detail
+}//namespace jet
@@ -0,0 +1,293 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_json_parser.hpp"
+#include "config_throw.hpp"
+#include <boost/noncopyable.hpp>
+#include <cstring>
+
+using tree             = boost::property_tree::ptree;
+
+namespace jet
+{
+namespace detail
+{
+
+namespace
+{
+
+class json_parser: boost::noncopyable
+{
+public:
+    json_parser(const char* begin, const char* end): begin_{begin}, pos_{begin}, end_{end} {}
+    void parse(tree& root)
+    {
+        static const char bom[]{"\xEF\xBB\xBF"};
+        if(end_ - pos_ >= 3 && 0 == std::memcmp(pos_, bom, 3))
+            pos_ += 3;
+        skip_space();
+        expect('{');
+        parse_object(root, 1);
+        skip_space();
+        if(end_ != pos_)
+            error("unexpected data after the end of document");
+    }
+private:
+    static const size_t max_depth{512};
+
+    void parse_object(tree& parent, size_t depth)
+    {//...'{' is already consumed
+        if(depth > max_depth)
+            error("nesting is too deep");
+        skip_space();
+        if(consume('}'))
+            return;
+        std::string name;
+        for(;;)
+        {
+            skip_space();
+            expect('"');
+            parse_string(name);
+            skip_space();
+            expect(':');
+            skip_space();
+            if(consume('['))
+                parse_array(parent, name, depth);
+            else
+                parse_value(parent.push_back({name, tree{}})->second, depth);
+            skip_space();
+            if(consume(','))
+                continue;
+            expect('}');
+            return;
+        }
+    }
+    void parse_array(tree& parent, const std::string& name, size_t depth)
+    {//...'[' is already consumed
+        skip_space();
+        if(consume(']'))
+            return;
+        for(;;)
+        {
+            skip_space();
+            if(end_ != pos_ && '[' == *pos_)
+                error("arrays of arrays are not supported");
+            parse_value(parent.push_back({name, tree{}})->second, depth);
+            skip_space();
+            if(consume(','))
+                continue;
+            expect(']');
+            return;
+        }
+    }
+    void parse_value(tree& node, size_t depth)
+    {
+        if(end_ == pos_)
+            error("unexpected end of document");
+        switch(*pos_)
+        {
+            case '{':
+                ++pos_;
+                parse_object(node, depth + 1);
+                break;
+            case '"':
+                ++pos_;
+                parse_string(node.data());
+                break;
+            case 't':
+                parse_literal("true", node.data());
+                break;
+            case 'f':
+                parse_literal("false", node.data());
+                break;
+            case 'n':
+                parse_literal("null", node.data());
+                node.data().clear();
+                break;
+            default:
+                parse_number(node.data());
+        }
+    }
+    void parse_literal(const char* literal, std::string& value)
+    {
+        const size_t size{std::strlen(literal)};
+        if(static_cast<size_t>(end_ - pos_) < size || 0 != std::memcmp(pos_, literal, size))
+            error("invalid value");
+        value.assign(pos_, size);
+        pos_ += size;
+    }
+    void parse_number(std::string& value)
+    {
+        const char* const start{pos_};
+        consume('-');
+        if(!consume('0') && !skip_digits())
+            error("invalid value");
+        if(consume('.') && !skip_digits())
+            error("expected digit");
+        if(consume('e') || consume('E'))
+        {
+            if(!consume('+'))
+                consume('-');
+            if(!skip_digits())
+                error("expected digit");
+        }
+        value.assign(start, pos_);
+    }
+    void parse_string(std::string& value)
+    {//...opening '"' is already consumed
+        const char* start{pos_};
+        while(end_ != pos_ && '"' != *pos_ && '\\' != *pos_ && static_cast<unsigned char>(*pos_) >= 0x20)
+            ++pos_;
+        value.assign(start, pos_);
+        for(;;)
+        {
+            if(end_ == pos_)
+                error("unterminated string");
+            const char c{*pos_++};
+            if('"' == c)
+                return;
+            if(static_cast<unsigned char>(c) < 0x20)
+            {
+                --pos_;
+                error("control character in string");
+            }
+            if('\\' != c)
+            {
+                value += c;
+                continue;
+            }
+            if(end_ == pos_)
+                error("unterminated string");
+            switch(*pos_++)
+            {
+                case '"':  value += '"'; break;
+                case '\\': value += '\\'; break;
+                case '/':  value += '/'; break;
+                case 'b':  value += '\b'; break;
+                case 'f':  value += '\f'; break;
+                case 'n':  value += '\n'; break;
+                case 'r':  value += '\r'; break;
+                case 't':  value += '\t'; break;
+                case 'u':  append_code_point(value); break;
+                default:
+                    --pos_;
+                    error("invalid escape sequence");
+            }
+        }
+    }
+    void append_code_point(std::string& value)
+    {//...'\u' is already consumed, surrogate pairs are combined into one code point
+        unsigned long code{parse_hex4()};
+        if(code >= 0xDC00 && code <= 0xDFFF)
+            error("invalid unicode escape sequence");
+        if(code >= 0xD800 && code <= 0xDBFF)
+        {
+            if(!consume('\\') || !consume('u'))
+                error("invalid unicode escape sequence");
+            const unsigned long low{parse_hex4()};
+            if(low < 0xDC00 || low > 0xDFFF)
+                error("invalid unicode escape sequence");
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        if(code < 0x80)
+            value += static_cast<char>(code);
+        else if(code < 0x800)
+        {
+            value += static_cast<char>(0xC0 | (code >> 6));
+            value += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if(code < 0x10000)
+        {
+            value += static_cast<char>(0xE0 | (code >> 12));
+            value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            value += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            value += static_cast<char>(0xF0 | (code >> 18));
+            value += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            value += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            value += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    unsigned long parse_hex4()
+    {
+        unsigned long code{};
+        for(int i = 0; i < 4; ++i, ++pos_)
+        {
+            if(end_ == pos_)
+                error("unterminated string");
+            const char c{*pos_};
+            code <<= 4;
+            if(c >= '0' && c <= '9')
+                code |= c - '0';
+            else if(c >= 'a' && c <= 'f')
+                code |= c - 'a' + 10;
+            else if(c >= 'A' && c <= 'F')
+                code |= c - 'A' + 10;
+            else
+                error("invalid unicode escape sequence");
+        }
+        return code;
+    }
+    bool skip_digits()
+    {
+        const char* const start{pos_};
+        while(end_ != pos_ && *pos_ >= '0' && *pos_ <= '9')
+            ++pos_;
+        return start != pos_;
+    }
+    void skip_space()
+    {
+        while(end_ != pos_ && (' ' == *pos_ || '\n' == *pos_ || '\r' == *pos_ || '\t' == *pos_))
+            ++pos_;
+    }
+    bool consume(char c)
+    {
+        if(end_ == pos_ || c != *pos_)
+            return false;
+        ++pos_;
+        return true;
+    }
+    void expect(char c)
+    {
+        if(!consume(c))
+            error(std::string{"expected '"} + c + '\'');
+    }
+    void error[[noreturn]](const std::string& message) const
+    {
+        size_t line{1}, column{1};
+        for(const char* iter = begin_; pos_ != iter; ++iter)
+        {
+            if('\n' == *iter)
+            {
+                ++line;
+                column = 1;
+            }
+            else
+                ++column;
+        }
+        JET_THROW_CFG() << "Invalid JSON at line " << line << ", column " << column << ": " << message;
+    }
+    //...
+    const char* const begin_;
+    const char* pos_;
+    const char* const end_;
+};
+
+const size_t json_parser::max_depth;
+
+}//anonymous namespace
+
+void read_json(const char* begin, const char* end, tree& root)
+{
+    json_parser{begin, end}.parse(root);
+}
+
+}//namespace detail
+}//namespace jet
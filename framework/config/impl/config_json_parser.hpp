@@ -0,0 +1,28 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_JSON_PARSER_HEADER_GUARD
+#define JET_CONFIG_CONFIG_JSON_PARSER_HEADER_GUARD
+
+#include <boost/property_tree/ptree.hpp>
+
+namespace jet
+{
+namespace detail
+{
+
+//...single pass JSON reader which builds the tree in the form XML source has after attributes
+//...normalization: object members are child nodes, scalars are node data (null is empty data)
+//...and elements of array are repeated nodes with the name of array.
+//...Document must be an object, arrays of arrays are not supported
+void read_json(const char* begin, const char* end, boost::property_tree::ptree& root);
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_JSON_PARSER_HEADER_GUARD*/
@@ -0,0 +1,53 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_MAPPED_FILE_HEADER_GUARD
+#define JET_CONFIG_CONFIG_MAPPED_FILE_HEADER_GUARD
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+namespace jet
+{
+namespace detail
+{
+
+//...read-only mapping of the whole file. Empty file can't be mapped, it's represented by empty buffer
+class mapped_file: boost::noncopyable
+{
+public:
+    explicit mapped_file(const std::string& filename):
+        file_{filename.c_str(), boost::interprocess::read_only}
+    {
+        try
+        {
+            boost::interprocess::mapped_region region{file_, boost::interprocess::read_only};
+            region_.swap(region);
+        }
+        catch(const boost::interprocess::interprocess_exception&)
+        {
+            std::ifstream file{filename, std::ios::in | std::ios::binary | std::ios::ate};
+            if(!file || 0 != file.tellg())
+                throw;
+        }
+    }
+    const char* data() const { return static_cast<const char*>(region_.get_address()); }
+    std::size_t size() const { return region_.get_size(); }
+private:
+    boost::interprocess::file_mapping file_;
+    boost::interprocess::mapped_region region_;
+};
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_MAPPED_FILE_HEADER_GUARD*/
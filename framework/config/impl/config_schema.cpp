@@ -0,0 +1,27 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_schema.hpp"
+#include "config_throw.hpp"
+
+namespace jet
+{
+
+void detail::throw_schema_error(const std::string& node_name, const std::vector<std::string>& errors)
+{
+    std::string message;
+    for(const std::string& error : errors)
+    {
+        if(!message.empty())
+            message += "; ";
+        message += error;
+    }
+    JET_THROW_CFG() << "Config '" << node_name << "' doesn't match schema: " << message;
+}
+
+}//namespace jet
@@ -0,0 +1,834 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_snapshot.hpp"
+#include "config_mapped_file.hpp"
+#include "config_case.hpp"
+#include "config_child_index.hpp"
+#include "config_source_impl.hpp"
+#include "config_throw.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+namespace PT           = boost::property_tree;
+using value_type       = PT::ptree::value_type;
+using tree             = PT::ptree;
+using index_type       = jet::config_snapshot::index_type;
+
+namespace jet
+{
+
+namespace
+{
+
+const index_type hash_seed{2166136261u};
+const char image_magic[8]{'j', 'e', 't', '.', 'c', 'f', 'g', '\0'};
+const index_type image_version{7};
+const index_type image_byte_order{0x01020304u};
+
+inline index_type hash_append(index_type hash, const char* data, size_t size)
+{//...FNV-1a, so the hash of a path can be continued from the hash of its prefix
+    for(const char* end = data + size; end != data; ++data)
+    {
+        hash ^= static_cast<unsigned char>(*data);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline index_type hash_append_lower(index_type hash, const char* data, size_t size)
+{//...the same as hash_append of the string in lower case
+    for(const char* end = data + size; end != data; ++data)
+    {
+        hash ^= static_cast<unsigned char>(detail::to_lower(*data));
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+inline std::uint64_t hash_append64(std::uint64_t hash, const char* data, size_t size)
+{//...64 bit FNV-1a
+    for(const char* end = data + size; end != data; ++data)
+    {
+        hash ^= static_cast<unsigned char>(*data);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline index_type hash_key(index_type rel_hash, index_type base)
+{
+    index_type hash{rel_hash ^ (base * 0x9E3779B1u)};
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    return hash;
+}
+
+inline detail::config_value convert(boost::string_ref text)
+{//...the same conversion as config_node::get<T> does, so cached values are interchangeable with it
+    detail::config_value result{};
+    if(text.empty())
+        return result;
+    if(detail::parse_integer(text, result.integer))
+        result.flags |= detail::config_value::integer_flag;
+    if(detail::parse_floating(text, result.floating))
+        result.flags |= detail::config_value::floating_flag;
+    bool boolean{};
+    if(detail::parse_boolean(text, boolean))
+    {
+        result.flags |= detail::config_value::boolean_flag;
+        result.integer = boolean ? 1 : 0;
+    }
+    return result;
+}
+
+inline size_t align_offset(size_t offset)
+{
+    const size_t alignment{8};
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+inline bool is_space(char c)
+{
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c;
+}
+
+}//anonymous namespace
+
+const index_type config_snapshot::npos;
+
+//...writes image in place: sizes of all parts are counted by derived builder first, so image is
+//...allocated once (only arrays, which are known when all nodes are added, are appended to it).
+//...Nodes are added in BFS order, so children of every node are contiguous.
+//...Equal values are stored once, paths are stored in the image too. Names are interned (once per
+//...image) if 'symbols' are given, so names of nodes of two snapshots are compared as integers
+class config_snapshot::writer: boost::noncopyable
+{
+protected:
+    writer(bool ignore_case, detail::symbol_references* symbols):
+        ignore_case_{ignore_case},
+        symbols_{symbols}
+    {}
+    void count_value(boost::string_ref value, size_t& strings_size)
+    {
+        if(values_.insert({value, npos}).second)
+            strings_size += value.size();
+    }
+    void allocate(
+        size_t node_count,
+        size_t strings_size,
+        const std::string& app_name,
+        const std::string& instance_name,
+        std::vector<char>& image)
+    {
+        strings_size += app_name.size() + instance_name.size();
+        if(node_count >= npos / 2 || strings_size >= npos)
+            JET_THROW_CFG() << "Config is too big: " << node_count << " nodes, " << strings_size << " bytes";
+        size_t table_size{16};
+        while(table_size < node_count * 2)
+            table_size <<= 1;
+        const size_t nodes_offset{align_offset(sizeof(header))};
+        const size_t table_offset{align_offset(nodes_offset + node_count * sizeof(node))};
+        const size_t strings_offset{align_offset(table_offset + table_size * sizeof(slot))};
+        image.assign(align_offset(strings_offset + strings_size), 0);
+        image_ = &image;
+        nodes_ = reinterpret_cast<node*>(image.data() + nodes_offset);
+        table_ = reinterpret_cast<slot*>(image.data() + table_offset);
+        table_size_ = static_cast<index_type>(table_size);
+        strings_ = image.data() + strings_offset;
+        std::fill(table_, table_ + table_size, slot{0, npos});
+        node_capacity_ = node_count;
+        strings_size_ = strings_size;
+
+        header hdr{};
+        std::memcpy(hdr.magic, image_magic, sizeof(hdr.magic));
+        hdr.version = image_version;
+        hdr.node_size = sizeof(node);
+        hdr.byte_order = image_byte_order;
+        hdr.flags = ignore_case_ ? ignore_case_flag : 0;
+        hdr.node_count = static_cast<index_type>(node_count);
+        hdr.table_size = table_size_;
+        hdr.strings_size = static_cast<index_type>(strings_size);
+        hdr.app_name_offset = append(app_name.data(), app_name.size());
+        hdr.app_name_size = static_cast<index_type>(app_name.size());
+        hdr.instance_name_offset = append(instance_name.data(), instance_name.size());
+        hdr.instance_name_size = static_cast<index_type>(instance_name.size());
+        std::memcpy(image.data(), &hdr, sizeof(hdr));
+    }
+    node& add_root()
+    {
+        node& root{nodes_[node_count_++]};
+        root.name_symbol = npos;
+        root.link = npos;
+        root.rel_hash = hash_seed;
+        return root;
+    }
+    //...'name_symbol' is symbol of the name if it's already interned
+    node& add_node(index_type parent_index, boost::string_ref name, index_type name_symbol = npos)
+    {
+        const node& parent{nodes_[parent_index]};
+        const index_type index{node_count_};
+        node& child{nodes_[node_count_++]};
+        const boost::string_ref parent_path{path(strings_, parent)};
+        child.path_offset = static_cast<index_type>(strings_end_);
+        append(parent_path.data(), parent_path.size());
+        if(!parent_path.empty())
+            append(NODE_DELIMITER, 1);
+        const index_type name_offset{append(name.data(), name.size())};
+        child.path_size = static_cast<index_type>(strings_end_ - child.path_offset);
+        child.name_symbol = npos;
+        if(symbols_)
+        {
+            if(npos == name_symbol)
+            {//...name in the image is the key, so it lives as long as the writer
+                const auto inserted = names_.insert({boost::string_ref{strings_ + name_offset, name.size()}, npos});
+                if(inserted.second)
+                    inserted.first->second = symbols_->intern(name);
+                name_symbol = inserted.first->second;
+            }
+            child.name_symbol = name_symbol;
+        }
+        child.name_size = static_cast<index_type>(name.size());
+        child.link = npos;
+        //...only the first of repeated nodes is reachable by path (the same way as in ptree),
+        //...names with delimiter inside are not reachable at all
+        const bool reachable{
+            !name.empty() &&
+            boost::string_ref::npos == name.find(NODE_DELIMITER[0]) &&
+            !find(nodes_, table_, table_size_, strings_, ignore_case_, parent, name)};
+        if(reachable)
+        {
+            index_type rel_hash{parent.rel_hash};
+            if(parent.rel_size)
+                rel_hash = hash_append(rel_hash, NODE_DELIMITER, 1);
+            child.base = parent.base;
+            child.rel_size = parent.rel_size + (parent.rel_size ? 1 : 0) + child.name_size;
+            child.rel_hash = ignore_case_ ?
+                hash_append_lower(rel_hash, name.data(), name.size()) :
+                hash_append(rel_hash, name.data(), name.size());
+            insert(hash_key(child.rel_hash, child.base), index);
+        }
+        else
+        {
+            child.base = index;
+            child.rel_size = 0;
+            child.rel_hash = hash_seed;
+        }
+        return child;
+    }
+    void set_value(node& n, boost::string_ref value, const detail::config_value& typed)
+    {
+        index_type& offset{values_.find(value)->second};
+        if(npos == offset)
+            offset = append(value.data(), value.size());
+        n.value_offset = offset;
+        n.value_size = static_cast<index_type>(value.size());
+        n.typed = typed;
+    }
+    void set_value(node& n, boost::string_ref value)
+    {
+        set_value(n, value, convert(value));
+    }
+    void finish()
+    {//...children always follow their parent, so hashes of subtrees are done in reverse order.
+     //...Nodes which share children of base snapshot have hash of base node already
+        for(index_type index = node_count_; index > 0; --index)
+        {
+            if(npos == nodes_[index - 1].link)
+                hash_subtree(nodes_[index - 1]);
+        }
+        assert(node_count_ == node_capacity_);
+        assert(strings_end_ == strings_size_);
+        add_arrays();
+    }
+    //...
+    node* nodes_{};
+    index_type node_count_{};
+private:
+    index_type append(const char* data, size_t size)
+    {
+        const index_type offset{static_cast<index_type>(strings_end_)};
+        if(size)
+            std::memcpy(strings_ + strings_end_, data, size);
+        strings_end_ += size;
+        return offset;
+    }
+    //...the first of repeated leaves (it's the one which is found by path) gets elements of all of
+    //...them, other leaves get their own array if they have more than one element.
+    //...Arrays are appended to the image, so it's the last step of writing
+    void add_arrays()
+    {
+        std::vector<char> arrays;
+        for(index_type index = 0; index < node_count_; ++index)
+            nodes_[index].typed.array = npos;
+        for(index_type index = 0; index < node_count_; ++index)
+        {
+            const node& parent{nodes_[index]};
+            if(npos != parent.link || !parent.child_count)
+                continue;
+            groups_.clear();
+            const index_type end{parent.first_child + parent.child_count};
+            for(index_type child = parent.first_child; child != end; ++child)
+            {
+                const index_type head{group_head(parent, child)};
+                if(head == child)
+                    continue;
+                std::vector<text_ref>& group{groups_[head]};
+                if(group.empty())
+                    split(nodes_[head], group);
+                const size_t group_size{group.size()};
+                split(nodes_[child], group);
+                if(group.size() - group_size > 1)
+                    add_array(nodes_[child], &group[group_size], group.size() - group_size, arrays);
+            }
+            for(index_type child = parent.first_child; child != end; ++child)
+            {
+                if(nodes_[child].child_count || groups_.count(child) || group_head(parent, child) != child)
+                    continue;
+                elements_.clear();
+                split(nodes_[child], elements_);
+                if(elements_.size() > 1)
+                    add_array(nodes_[child], elements_.data(), elements_.size(), arrays);
+            }
+            for(const auto& group : groups_)
+            {
+                if(!group.second.empty())
+                    add_array(nodes_[group.first], group.second.data(), group.second.size(), arrays);
+            }
+        }
+        if(arrays.size() >= npos)
+            JET_THROW_CFG() << "Config is too big: " << arrays.size() << " bytes of arrays";
+        reinterpret_cast<header*>(image_->data())->arrays_size = static_cast<index_type>(arrays.size());
+        image_->insert(image_->end(), arrays.begin(), arrays.end());//...nodes are moved
+        nodes_ = nullptr;
+    }
+    //...the first leaf sibling with the same name (the node itself if it's reachable or not a leaf)
+    index_type group_head(const node& parent, index_type child) const
+    {
+        const node& n{nodes_[child]};
+        if(n.child_count || n.base != child)
+            return child;
+        const boost::string_ref node_path{path(strings_, n)};
+        const boost::string_ref name{node_path.substr(node_path.size() - n.name_size)};
+        if(name.empty() || boost::string_ref::npos != name.find(NODE_DELIMITER[0]))
+            return child;
+        const node* const head{find(nodes_, table_, table_size_, strings_, ignore_case_, parent, name)};
+        if(!head || head->child_count)
+            return child;
+        return static_cast<index_type>(head - nodes_);
+    }
+    void split(const node& n, std::vector<text_ref>& elements) const
+    {//...elements are trimmed, empty value has no elements
+        if(!n.value_size)
+            return;
+        const char* const begin{strings_ + n.value_offset};
+        const char* const end{begin + n.value_size};
+        for(const char* pos = begin;; ++pos)
+        {
+            const char* const last{std::find(pos, end, ',')};
+            const char* first{pos};
+            const char* stop{last};
+            while(first != stop && is_space(*first))
+                ++first;
+            while(first != stop && is_space(*(stop - 1)))
+                --stop;
+            elements.push_back(text_ref{
+                static_cast<index_type>(first - strings_),
+                static_cast<index_type>(stop - first)});
+            if(end == last)
+                break;
+            pos = last;
+        }
+    }
+    void add_array(node& n, const text_ref* elements, size_t size, std::vector<char>& arrays) const
+    {
+        const size_t offset{arrays.size()};
+        arrays.resize(offset + sizeof(array_header) + size * (sizeof(std::int64_t) + sizeof(double) + sizeof(text_ref)));
+        char* const data{arrays.data() + offset};
+        array_header& hdr{*reinterpret_cast<array_header*>(data)};
+        std::int64_t* const integers{reinterpret_cast<std::int64_t*>(data + sizeof(array_header))};
+        double* const floatings{reinterpret_cast<double*>(integers + size)};
+        text_ref* const texts{reinterpret_cast<text_ref*>(floatings + size)};
+        hdr.size = static_cast<index_type>(size);
+        hdr.flags = detail::config_value::integer_flag | detail::config_value::floating_flag;
+        for(size_t index = 0; index < size; ++index)
+        {
+            const detail::config_value value{convert({strings_ + elements[index].offset, elements[index].size})};
+            integers[index] = value.integer;
+            floatings[index] = value.floating;
+            texts[index] = elements[index];
+            hdr.flags &= value.flags;
+        }
+        n.typed.array = static_cast<index_type>(offset);
+    }
+    void hash_subtree(node& n) const
+    {
+        const char delimiter{'\0'};
+        std::uint64_t hash{14695981039346656037ull};
+        const boost::string_ref node_path{path(strings_, n)};
+        hash = hash_append64(hash, node_path.data() + node_path.size() - n.name_size, n.name_size);
+        hash = hash_append64(hash, &delimiter, 1);
+        hash = hash_append64(hash, strings_ + n.value_offset, n.value_size);
+        for(index_type child = n.first_child; child != n.first_child + n.child_count; ++child)
+        {
+            const std::uint64_t child_hash{nodes_[child].subtree_hash};
+            hash = hash_append64(hash, reinterpret_cast<const char*>(&child_hash), sizeof(child_hash));
+        }
+        n.subtree_hash = hash;
+    }
+    void insert(index_type hash, index_type index)
+    {
+        const index_type mask{table_size_ - 1};
+        index_type pos{hash & mask};
+        while(npos != table_[pos].node)
+            pos = (pos + 1) & mask;
+        table_[pos] = slot{hash, index};
+    }
+    //...
+    size_t node_capacity_{};
+    slot* table_{};
+    index_type table_size_{};
+    char* strings_{};
+    size_t strings_size_{}, strings_end_{};
+    std::unordered_map<boost::string_ref, index_type, detail::name_hash> values_;//...value -> offset in strings
+    const bool ignore_case_;
+    detail::symbol_references* const symbols_;//...null if names are not interned
+    std::unordered_map<boost::string_ref, index_type, detail::name_hash> names_;//...name -> symbol
+    std::vector<char>* image_{};
+    std::unordered_map<index_type, std::vector<text_ref>> groups_;//...the first of repeated leaves -> elements
+    std::vector<text_ref> elements_;
+};
+
+//...image of merged tree
+class config_snapshot::builder: private config_snapshot::writer
+{
+public:
+    builder(
+        const tree& root,
+        const std::string& app_name,
+        const std::string& instance_name,
+        bool ignore_case,
+        detail::symbol_references* symbols,
+        std::vector<char>& image):
+        writer{ignore_case, symbols}
+    {
+        size_t node_count{1}, strings_size{};
+        count_value(root.data(), strings_size);
+        count(root, 0, node_count, strings_size);
+        allocate(node_count, strings_size, app_name, instance_name, image);
+        trees_.reserve(node_count);
+        set_value(add_root(), root.data());
+        trees_.push_back(&root);
+        for(index_type index = 0; index < node_count_; ++index)
+        {
+            const tree& parent_tree{*trees_[index]};
+            nodes_[index].first_child = node_count_;
+            nodes_[index].child_count = static_cast<index_type>(parent_tree.size());
+            for(const value_type& child : parent_tree)
+            {
+                set_value(add_node(index, child.first), child.second.data());
+                trees_.push_back(&child.second);
+            }
+        }
+        finish();
+    }
+private:
+    void count(const tree& parent, size_t path_size, size_t& node_count, size_t& strings_size)
+    {
+        for(const value_type& child : parent)
+        {
+            const size_t child_path_size{path_size + (path_size ? 1 : 0) + child.first.size()};
+            ++node_count;
+            strings_size += child_path_size;
+            count_value(child.second.data(), strings_size);
+            count(child.second, child_path_size, node_count, strings_size);
+        }
+    }
+    //...
+    std::vector<const tree*> trees_;
+};
+
+//...image of base snapshot with delta tree merged into it. Only nodes which are changed by delta
+//...(merged, replaced or added) and their siblings are in the image, siblings which are not changed
+//...share children of their base nodes, so unchanged subtrees are not copied
+class config_snapshot::overlay_builder: private config_snapshot::writer
+{
+public:
+    overlay_builder(
+        const config_snapshot& base,
+        const tree& delta,
+        const std::string& app_name,
+        const std::string& instance_name,
+        detail::symbol_references& symbols,
+        std::vector<char>& image):
+        writer{base.ignore_case(), &symbols},
+        base_(base)
+    {
+        items_.push_back(item{&base.root(), has_children(delta) ? &delta : nullptr, boost::string_ref{}, 0});
+        for(size_t index = 0; index < items_.size(); ++index)
+        {
+            const item current(items_[index]);
+            items_[index].first_child = items_.size();
+            if(!current.base)
+            {
+                for(const value_type& child : *current.delta)
+                    items_.push_back(item{nullptr, &child.second, child.first, index});
+            }
+            else if(current.delta && !current.delta->empty())
+                plan_merge(*current.base, *current.delta, index);
+            items_[index].child_count = items_.size() - items_[index].first_child;
+        }
+        size_t strings_size{};
+        for(size_t index = 0; index < items_.size(); ++index)
+        {
+            item& current(items_[index]);
+            if(index)
+            {
+                const size_t parent_path_size{items_[current.parent].path_size};
+                current.path_size = parent_path_size + (parent_path_size ? 1 : 0) + current.name.size();
+            }
+            strings_size += current.path_size;
+            count_value(value(current), strings_size);
+        }
+        allocate(items_.size(), strings_size, app_name, instance_name, image);
+        for(size_t index = 0; index < items_.size(); ++index)
+        {
+            const item& current(items_[index]);
+            const index_type name_symbol{current.base ? current.base->name_symbol : npos};
+            node& n(index ? add_node(static_cast<index_type>(current.parent), current.name, name_symbol) : add_root());
+            if(current.base && !current.delta && current.base->child_count)
+            {//...children are shared with base node
+                set_value(n, value(current), current.base->typed);
+                n.first_child = current.base->first_child;
+                n.child_count = current.base->child_count;
+                n.link = static_cast<index_type>(current.base - base_.nodes_);
+                n.subtree_hash = current.base->subtree_hash;
+            }
+            else
+            {
+                if(current.base && (!current.delta || !current.delta->empty()))
+                    set_value(n, value(current), current.base->typed);
+                else
+                    set_value(n, value(current));
+                n.first_child = static_cast<index_type>(current.first_child);
+                n.child_count = static_cast<index_type>(current.child_count);
+            }
+        }
+        finish();
+    }
+private:
+    //...node of overlay: 'base' is node of base snapshot which is shared (no delta), replaced (delta
+    //...without children) or merged with 'delta'; node without base is a new subtree of delta
+    struct item
+    {
+        const node* base;
+        const tree* delta;
+        boost::string_ref name;
+        size_t parent, first_child, child_count, path_size;
+        item(const node* base, const tree* delta, boost::string_ref name, size_t parent):
+            base{base}, delta{delta}, name{name}, parent{parent}, first_child{}, child_count{}, path_size{}
+        {}
+    };
+    static bool has_children(const tree& delta)
+    {
+        for(const value_type& child : delta)
+        {
+            if(INSTANCE_NODE_NAME != child.first)
+                return true;
+        }
+        return false;
+    }
+    boost::string_ref value(const item& current) const
+    {//...merged node keeps value of base node
+        if(current.base && (!current.delta || !current.delta->empty()))
+            return base_.value(*current.base);
+        return current.delta->data();
+    }
+    void plan_merge(const node& base, const tree& delta, size_t parent)
+    {//...the same as merge of delta into tree of base node: children of base keep their order, the
+     //...ones which have delta child with the same name are merged with it or replaced by it,
+     //...delta children with new names are appended. Merge has to be checked for ambiguity already
+        merged_.clear();
+        for(const value_type& child : delta)
+        {
+            if(INSTANCE_NODE_NAME != child.first)
+                merged_.insert({child.first, delta_child{&child.second, false}});
+        }
+        for(const node* child = base_.children_begin(base); base_.children_end(base) != child; ++child)
+        {
+            const boost::string_ref name{base_.name(*child)};
+            const auto iter = merged_.find(name);
+            if(merged_.end() == iter)
+                items_.push_back(item{child, nullptr, name, parent});
+            else
+            {
+                items_.push_back(item{child, iter->second.delta, name, parent});
+                iter->second.matched = true;
+            }
+        }
+        for(const value_type& child : delta)
+        {
+            if(INSTANCE_NODE_NAME != child.first && !merged_.find(child.first)->second.matched)
+                items_.push_back(item{nullptr, &child.second, child.first, parent});
+        }
+    }
+    //...
+    struct delta_child
+    {
+        const tree* delta;//...the first delta child with the name
+        bool matched;
+    };
+    const config_snapshot& base_;
+    std::vector<item> items_;
+    std::unordered_map<boost::string_ref, delta_child, detail::name_hash> merged_;
+};
+
+config_snapshot::config_snapshot(
+    const tree& root,
+    const std::string& app_name,
+    const std::string& instance_name,
+    bool ignore_case)
+{
+    const std::shared_ptr<std::vector<char>> image{std::make_shared<std::vector<char>>()};
+    builder(root, app_name, instance_name, ignore_case, &symbols_, *image);
+    storage_ = image;
+    attach(image->data(), image->size());
+}
+
+config_snapshot::config_snapshot(
+    const std::shared_ptr<const config_snapshot>& base,
+    const tree& delta,
+    const std::string& app_name,
+    const std::string& instance_name):
+    base_{base}
+{
+    const std::shared_ptr<std::vector<char>> image{std::make_shared<std::vector<char>>()};
+    overlay_builder(*base, delta, app_name, instance_name, symbols_, *image);
+    storage_ = image;
+    attach(image->data(), image->size());
+}
+
+config_snapshot::config_snapshot(const std::string& image_filename)
+{
+    const std::shared_ptr<detail::mapped_file> image{std::make_shared<detail::mapped_file>(image_filename)};
+    storage_ = image;
+    attach(image->data(), image->size());
+    validate();
+}
+
+void config_snapshot::attach(const char* image, size_t image_size)
+{//...only the header is checked here, content of image read from file is checked by validate()
+    if(image_size < sizeof(header))
+        JET_THROW_CFG() << "Config image is truncated: " << image_size << " bytes";
+    header_ = reinterpret_cast<const header*>(image);
+    if(0 != std::memcmp(header_->magic, image_magic, sizeof(image_magic)))
+        JET_THROW_CFG() << "Config image has unknown format";
+    if( image_version != header_->version ||
+        sizeof(node) != header_->node_size ||
+        image_byte_order != header_->byte_order )
+        JET_THROW_CFG()
+            << "Config image version " << header_->version
+            << " is incompatible with version " << image_version << " of this platform";
+    const size_t nodes_offset{align_offset(sizeof(header))};
+    const size_t table_offset{align_offset(nodes_offset + size_t{header_->node_count} * sizeof(node))};
+    const size_t strings_offset{align_offset(table_offset + size_t{header_->table_size} * sizeof(slot))};
+    const size_t arrays_offset{align_offset(strings_offset + header_->strings_size)};
+    if( !header_->node_count ||
+        header_->table_size < header_->node_count ||
+        0 != (header_->table_size & (header_->table_size - 1)) ||
+        size_t{header_->app_name_offset} + header_->app_name_size > header_->strings_size ||
+        size_t{header_->instance_name_offset} + header_->instance_name_size > header_->strings_size ||
+        arrays_offset + header_->arrays_size != image_size )
+        JET_THROW_CFG() << "Config image is corrupted";
+    image_ = image;
+    image_size_ = image_size;
+    nodes_ = reinterpret_cast<const node*>(image + nodes_offset);
+    table_ = reinterpret_cast<const slot*>(image + table_offset);
+    strings_ = image + strings_offset;
+    arrays_ = image + arrays_offset;
+}
+
+void config_snapshot::validate() const
+{//...file can be truncated or corrupted while keeping valid header, so every reference is checked
+ //...before it's used: children follow their parent (so tree has no cycles), paths are stored in
+ //...the image, lookup table has empty slot (so probing stops)
+    const size_t node_count{header_->node_count};
+    const size_t strings_size{header_->strings_size};
+    const size_t arrays_size{header_->arrays_size};
+    const auto in_strings = [strings_size](size_t offset, size_t size) { return offset + size <= strings_size; };
+    bool valid{true};
+    for(size_t index = 0; valid && index < node_count; ++index)
+    {
+        const node& n{nodes_[index]};
+        valid =
+            npos == n.name_symbol &&
+            npos == n.link &&
+            in_strings(n.path_offset, n.path_size) &&
+            n.name_size <= n.path_size &&
+            n.rel_size <= n.path_size &&
+            in_strings(n.value_offset, n.value_size) &&
+            n.base < node_count &&
+            (!n.child_count || (n.first_child > index && size_t{n.first_child} + n.child_count <= node_count));
+        if(valid && npos != n.typed.array)
+        {
+            const size_t element_size{sizeof(std::int64_t) + sizeof(double) + sizeof(text_ref)};
+            const size_t offset{n.typed.array};
+            valid = !(offset % alignof(std::int64_t)) && offset + sizeof(array_header) <= arrays_size;
+            if(!valid)
+                break;
+            const size_t size{reinterpret_cast<const array_header*>(arrays_ + offset)->size};
+            valid = size <= (arrays_size - offset - sizeof(array_header)) / element_size;
+            const text_ref* const texts{reinterpret_cast<const text_ref*>(
+                arrays_ + offset + sizeof(array_header) + size * (sizeof(std::int64_t) + sizeof(double)))};
+            for(size_t element = 0; valid && element < size; ++element)
+                valid = in_strings(texts[element].offset, texts[element].size);
+        }
+    }
+    bool has_empty_slot{false};
+    for(size_t pos = 0; valid && pos < header_->table_size; ++pos)
+    {
+        if(npos == table_[pos].node)
+            has_empty_slot = true;
+        else
+            valid = table_[pos].node < node_count;
+    }
+    if(!valid || !has_empty_slot)
+        JET_THROW_CFG() << "Config image is corrupted";
+}
+
+void config_snapshot::save(const std::string& image_filename) const
+{//...interned paths are valid only in this process, so the image with paths inside is rebuilt
+    std::vector<char> rebuilt;
+    const char* image{image_};
+    size_t image_size{image_size_};
+    if(root().child_count && npos != children_begin(root())->name_symbol)
+    {
+        builder(to_tree(root()), app_name().to_string(), instance_name().to_string(), ignore_case(), nullptr, rebuilt);
+        image = rebuilt.data();
+        image_size = rebuilt.size();
+    }
+    std::ofstream file{image_filename, std::ios::out | std::ios::binary | std::ios::trunc};
+    if(!file.write(image, static_cast<std::streamsize>(image_size)) || !file.flush())
+        JET_THROW_CFG() << "Couldn't write config image '" << image_filename << '\'';
+}
+
+const config_snapshot::node* config_snapshot::find(const node& from, boost::string_ref path) const
+{
+    if(!base_)
+        return find(nodes_, table_, header_->table_size, strings_, ignore_case(), from, path);
+    if(!own(from))//...node of subtree which is shared with base
+        return base_->find(from, path);
+    if(const node* const found = find(nodes_, table_, header_->table_size, strings_, ignore_case(), from, path))
+        return found;
+    //...path can lead into shared subtree: the longest prefix of path which is found in overlay has
+    //...to be the node which shares children with base, the rest of path is looked up in base
+    const node* last{&from};
+    size_t rest{0};
+    for(size_t end = path.find(NODE_DELIMITER[0]); boost::string_ref::npos != end;)
+    {
+        const node* const prefix{find(nodes_, table_, header_->table_size, strings_, ignore_case(), from, path.substr(0, end))};
+        if(!prefix)
+            break;
+        last = prefix;
+        rest = end + 1;
+        const size_t next{path.substr(rest).find(NODE_DELIMITER[0])};
+        end = boost::string_ref::npos == next ? next : rest + next;
+    }
+    if(npos == last->link)
+        return nullptr;
+    return base_->find(base_->nodes_[last->link], path.substr(rest));
+}
+
+const config_snapshot::node* config_snapshot::find(
+    const node* nodes,
+    const slot* table,
+    index_type table_size,
+    const char* strings,
+    bool ignore_case,
+    const node& from,
+    boost::string_ref path)
+{
+    if(path.empty())
+        return &from;
+    const boost::string_ref from_rel{rel_path(strings, from)};
+    const size_t key_size{from_rel.size() + (from_rel.empty() ? 0 : 1) + path.size()};
+    index_type rel_hash{from.rel_hash};
+    if(!from_rel.empty())
+        rel_hash = hash_append(rel_hash, NODE_DELIMITER, 1);
+    const index_type hash{hash_key(
+        ignore_case ? hash_append_lower(rel_hash, path.data(), path.size()) : hash_append(rel_hash, path.data(), path.size()),
+        from.base)};
+    const index_type mask{table_size - 1};
+    for(index_type pos = hash & mask;; pos = (pos + 1) & mask)
+    {
+        const slot& entry{table[pos]};
+        if(npos == entry.node)
+            return nullptr;
+        if(hash != entry.hash)
+            continue;
+        const node& candidate{nodes[entry.node]};
+        if(candidate.base != from.base || candidate.rel_size != key_size)
+            continue;
+        const boost::string_ref rel{rel_path(strings, candidate)};
+        if(ignore_case)
+        {//...the prefix of candidate is 'from' node itself, so it has the same case
+            if( detail::iequals(rel.substr(rel.size() - path.size()), path) &&
+                rel.starts_with(from_rel) &&
+                (from_rel.empty() || NODE_DELIMITER[0] == rel[from_rel.size()]) )
+                return &candidate;
+        }
+        else if( rel.ends_with(path) &&
+            rel.starts_with(from_rel) &&
+            (from_rel.empty() || NODE_DELIMITER[0] == rel[from_rel.size()]) )
+            return &candidate;
+    }
+}
+
+detail::config_array_data config_snapshot::array_of(const node& n) const
+{
+    if(npos != n.typed.array)
+    {
+        const char* const data{arrays_of(n) + n.typed.array};
+        const array_header& hdr{*reinterpret_cast<const array_header*>(data)};
+        const std::int64_t* const integers{reinterpret_cast<const std::int64_t*>(data + sizeof(array_header))};
+        return detail::config_array_data{
+            integers, reinterpret_cast<const double*>(integers + hdr.size), hdr.size, hdr.flags};
+    }
+    if(!n.value_size)
+        return detail::config_array_data{
+            nullptr, nullptr, 0, detail::config_value::integer_flag | detail::config_value::floating_flag};
+    return detail::config_array_data{&n.typed.integer, &n.typed.floating, 1, n.typed.flags};
+}
+
+boost::string_ref config_snapshot::array_element(const node& n, index_type index) const
+{
+    if(npos == n.typed.array)
+        return value(n);
+    const char* const data{arrays_of(n) + n.typed.array};
+    const index_type size{reinterpret_cast<const array_header*>(data)->size};
+    const text_ref& text{reinterpret_cast<const text_ref*>(
+        data + sizeof(array_header) + size * (sizeof(std::int64_t) + sizeof(double)))[index]};
+    return {strings_of(n) + text.offset, text.size};
+}
+
+tree config_snapshot::to_tree(const node& n) const
+{
+    tree result{value(n).to_string()};
+    for(const node* child = children_begin(n); children_end(n) != child; ++child)
+    {
+        tree& child_tree{result.push_back({name(*child).to_string(), tree{}})->second};
+        child_tree = to_tree(*child);
+    }
+    return result;
+}
+
+}//namespace jet
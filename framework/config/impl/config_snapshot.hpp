@@ -0,0 +1,181 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_SNAPSHOT_HEADER_GUARD
+#define JET_CONFIG_CONFIG_SNAPSHOT_HEADER_GUARD
+
+#include "config.hpp"
+#include "config_symbol_table.hpp"
+#include <boost/property_tree/ptree.hpp>
+#include <boost/utility/string_ref.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace jet
+{
+
+//...read-only image of a locked config tree. All nodes, the lookup table and all strings
+//...live in one contiguous buffer and refer to each other by index/offset, so the same buffer
+//...can be saved to file and mapped back into memory without any parsing.
+//...Names of nodes of snapshot built in memory are interned in process-wide symbol table (and
+//...released with the snapshot), so nodes of different snapshots are matched by integer symbols.
+//...Overlay snapshot is a base snapshot with delta tree merged into it: its image keeps only nodes
+//...changed by delta and their siblings, unchanged subtrees are read from base. Nodes of both are
+//...accessed through overlay the same way, so users don't see the difference
+class config_snapshot: boost::noncopyable
+{
+public:
+    using index_type = std::uint32_t;
+    static const index_type npos = static_cast<index_type>(-1);
+
+    //...children of every node are stored contiguously in document order.
+    //...'path' is the full dotted path from the config root stored in the image strings, 'name' is
+    //...its last part which is interned as 'name_symbol' (npos in image saved to file).
+    //...'base' and 'rel' identify node in the lookup table: node is reachable as 'rel' from 'base'
+    //...where 'base' is the closest ancestor which can't be reached by path (root or repeated node).
+    //...'subtree_hash' covers names and values of the node and all its descendants, so equal
+    //...subtrees of two snapshots can be skipped without visiting them.
+    //...'typed' keeps value converted to integer, floating and boolean (where conversion is possible)
+    //...and offset of its array in the image (see array_of).
+    //...'link' is index of base node whose children are shared by node of overlay (npos otherwise)
+    struct node
+    {
+        index_type path_offset, path_size, name_symbol;
+        index_type name_size;
+        index_type value_offset, value_size;
+        index_type first_child, child_count, link;
+        index_type base, rel_size, rel_hash;
+        std::uint64_t subtree_hash;
+        detail::config_value typed;
+    };
+
+    //...'ignore_case' makes find() match paths case-insensitively (ASCII only), names keep their case
+    config_snapshot(
+        const boost::property_tree::ptree& root,
+        const std::string& app_name,
+        const std::string& instance_name,
+        bool ignore_case = false);
+    explicit config_snapshot(const std::string& image_filename);//...maps image saved by save()
+    //...overlay: 'delta' is merged into 'base' the same way as instance node is merged into config
+    config_snapshot(
+        const std::shared_ptr<const config_snapshot>& base,
+        const boost::property_tree::ptree& delta,
+        const std::string& app_name,
+        const std::string& instance_name);
+
+    void save(const std::string& image_filename) const;
+    //...image and references to interned names, names themselves are shared by snapshots and counted
+    //...by symbol_table (base of overlay is not counted either)
+    std::size_t memory_usage() const { return image_size_ + symbols_.memory_usage(); }
+    boost::string_ref app_name() const { return {strings_ + header_->app_name_offset, header_->app_name_size}; }
+    boost::string_ref instance_name() const
+    {
+        return {strings_ + header_->instance_name_offset, header_->instance_name_size};
+    }
+
+    bool ignore_case() const { return 0 != (header_->flags & ignore_case_flag); }
+    const node& root() const { return nodes_[0]; }
+    const node* find(const node& from, boost::string_ref path) const;
+    const node* children_begin(const node& parent) const
+    {
+        if(!base_)
+            return nodes_ + parent.first_child;
+        return (own(parent) && npos == parent.link ? nodes_ : base_->nodes_) + parent.first_child;
+    }
+    const node* children_end(const node& parent) const { return children_begin(parent) + parent.child_count; }
+    boost::string_ref path(const node& n) const { return path(strings_of(n), n); }
+    boost::string_ref name(const node& n) const
+    {
+        const boost::string_ref node_path{path(n)};
+        return node_path.substr(node_path.size() - n.name_size);
+    }
+    //...true if nodes of two snapshots have the same name, interned names are compared as symbols
+    //...(it's enough for children of nodes with the same path)
+    bool same_name(const node& n, const config_snapshot& other, const node& other_node) const
+    {
+        if(npos != n.name_symbol && npos != other_node.name_symbol)
+            return n.name_symbol == other_node.name_symbol;
+        return name(n) == other.name(other_node);
+    }
+    boost::string_ref value(const node& n) const { return {strings_of(n) + n.value_offset, n.value_size}; }
+    //...elements of array property of leaf node: its value and (if it's the first of repeated nodes)
+    //...values of its repeated siblings, each one split by commas. Elements are converted when image
+    //...is built, node with a single element refers to its own typed value
+    detail::config_array_data array_of(const node& n) const;
+    boost::string_ref array_element(const node& n, index_type index) const;//...text of element
+
+    boost::property_tree::ptree to_tree(const node& n) const;
+private:
+    //...'node_size' and 'byte_order' reject images saved on a platform with different layout
+    struct header
+    {
+        char magic[8];
+        index_type version, node_size, byte_order, flags;
+        index_type node_count, table_size, strings_size, arrays_size;
+        index_type app_name_offset, app_name_size;
+        index_type instance_name_offset, instance_name_size;
+    };
+    struct slot
+    {
+        index_type hash, node;
+    };
+    //...array in the image: header is followed by 'size' integers, 'size' floatings and 'size' texts
+    struct array_header
+    {
+        index_type size, flags;
+    };
+    struct text_ref
+    {
+        index_type offset, size;//...in strings
+    };
+    static const index_type ignore_case_flag = 1;
+    class writer;
+    class builder;
+    class overlay_builder;
+    static const node* find(
+        const node* nodes,
+        const slot* table,
+        index_type table_size,
+        const char* strings,
+        bool ignore_case,
+        const node& from,
+        boost::string_ref path);
+    void attach(const char* image, std::size_t image_size);
+    void validate() const;//...throws if any index or offset inside image is out of its bounds
+    bool own(const node& n) const
+    {
+        return !std::less<const node*>{}(&n, nodes_) && std::less<const node*>{}(&n, nodes_ + header_->node_count);
+    }
+    const char* strings_of(const node& n) const { return !base_ || own(n) ? strings_ : base_->strings_; }
+    const char* arrays_of(const node& n) const { return !base_ || own(n) ? arrays_ : base_->arrays_; }
+    static boost::string_ref path(const char* strings, const node& n) { return {strings + n.path_offset, n.path_size}; }
+    static boost::string_ref rel_path(const char* strings, const node& n)
+    {
+        const boost::string_ref node_path{path(strings, n)};
+        return node_path.substr(node_path.size() - n.rel_size);
+    }
+    //...
+    std::shared_ptr<const void> storage_;
+    std::shared_ptr<const config_snapshot> base_;//...null if it isn't overlay
+    detail::symbol_references symbols_;//...names interned by this snapshot (not by its base)
+    const char* image_;
+    std::size_t image_size_;
+    const header* header_;
+    const node* nodes_;
+    const slot* table_;
+    const char* strings_;
+    const char* arrays_;
+};
+
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_SNAPSHOT_HEADER_GUARD*/
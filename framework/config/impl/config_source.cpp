@@ -7,6 +7,11 @@
 //
 
 #include "config_source_impl.hpp"
+#include "config_json_parser.hpp"
+#include "config_xml_parser.hpp"
+#include "config_case.hpp"
+#include "config_child_index.hpp"
+#include "config_mapped_file.hpp"
 #include "config_throw.hpp"
 #include <boost/property_tree/exceptions.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -14,7 +19,13 @@
 #include <boost/noncopyable.hpp>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/trim.hpp>
-#include <boost/range/adaptor/reversed.hpp>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
 
 namespace PT           = boost::property_tree;
 using value_type       = PT::ptree::value_type;
@@ -22,7 +33,6 @@ using tree_iter        = PT::ptree::iterator;
 using assoc_tree_iter  = PT::ptree::assoc_iterator;
 using cassoc_tree_iter = PT::ptree::const_assoc_iterator;
 using tree             = PT::ptree;
-using path             = PT::path;
 
 namespace jet
 {
@@ -30,6 +40,18 @@ namespace jet
 namespace
 {
 
+//...whole stream is read into memory for parsers which take buffer
+inline std::string read_all(std::istream& input)
+{
+    return std::string{std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+}
+
+inline void read_json(std::istream& input, tree& root)
+{
+    const std::string text{read_all(input)};
+    detail::read_json(text.data(), text.data() + text.size(), root);
+}
+
 inline std::string prune_string(const std::string& data, size_t maxSize = 10)
 {
     if(data.size() > maxSize)
@@ -42,194 +64,162 @@ inline std::string prune_string(const std::string& data, size_t maxSize = 10)
     return data;
 }
 
+//...all checks are done during one traversal of the tree. When source has several errors
+//...the reported one is the same as if checks were done one by one in order of 'check' enum
 class tree_validator: boost::noncopyable
 {
 public:
     tree_validator(const std::string& source_name, const tree& root):
-        source_name_{source_name}, root_{root}
+        source_name_{source_name}, root_{root}, failed_check_{no_error}
     {
         assert(root_.front().first == ROOT_NODE_NAME);
     }
-    void check_tree_does_not_have_data_and_attribute_nodes() const
+    void validate()
     {
         const tree::value_type& config { root_.front() };
-        
-        check_node_does_not_have_data_and_attribute(config.first, config.second);
-    }
-    void check_no_data_in_config_node() const
-    {
-        const tree::value_type& config {root_.front()};
         if(!config.second.data().empty())
-            JET_THROW_CFG()
+            fail(no_data_in_config_node)
                 << "Invalid data node '" << prune_string(config.second.data())
                 << "' under '" ROOT_NODE_NAME "' node in config source '" << source_name_ << '\'';
-    }
-    void check_no_data_in_default_node() const
-    {
-        const tree::value_type& config{root_.front()};
-        const cassoc_tree_iter default_iter { config.second.find(DEFAULT_NODE_NAME) };
-        if(config.second.not_found() == default_iter)
-            return;
-        if(!default_iter->second.data().empty())
-            JET_THROW_CFG()
-                << "Invalid data node '" << prune_string(default_iter->second.data())
-                << "' under '" DEFAULT_NODE_NAME "' node in config source '" << source_name_ << '\'';
-    }
-    void check_no_data_in_app_and_instance_node() const
-    {
-        const tree::value_type& config { root_.front() };
-        for(const tree::value_type& app_node : config.second)
+        std::string current_path{config.first};
+        check_node_does_not_have_data_and_attribute(current_path, config.second);
+        const detail::child_index config_names{config.second};
+        bool has_default_node{false};
+        for(const tree::value_type& node : config.second)
         {
-            if(DEFAULT_NODE_NAME == app_node.first)
-                continue;
-            if(!app_node.second.data().empty())
-                JET_THROW_CFG()
-                    << "Invalid data node '" << prune_string(app_node.second.data())
-                    << "' under '" << app_node.first << "' node in config source '" << source_name_ << '\'';
-            const cassoc_tree_iter instance_iter { app_node.second.find(INSTANCE_NODE_NAME) };
-            if(app_node.second.not_found() == instance_iter)
-                continue;
-            for(const tree::value_type& instanceNode : instance_iter->second)
+            if(DEFAULT_NODE_NAME == node.first)
             {
-                if(!instanceNode.second.data().empty())
-                {
-                    std::string instance_name { app_node.first };
-                    instance_name += INSTANCE_DELIMITER;
-                    instance_name += instanceNode.first;
-                    JET_THROW_CFG()
-                        << "Invalid data node '" << prune_string(instanceNode.second.data())
-                        << "' under '" << instance_name << "' node in config source '"
-                        << source_name_ << '\'';
-                }
+                if(has_default_node)
+                    fail(no_default_node_duplicates)
+                        << "Duplicate default node in config source '" << source_name_ << '\'';
+                else
+                    check_default_node(node.second);
+                has_default_node = true;
             }
+            else
+                check_app_node(node.first, node.second);
+            if(config_names.count(node.first) > 1)
+                fail(no_app_node_duplicates)
+                    << "Duplicate node '" << node.first
+                    << "' in config source '" << source_name_ << '\'';
         }
+        if(no_error != failed_check_)
+            JET_THROW_CFG() << error_.str();
     }
-    void check_no_default_node_duplicates() const
+private:
+    enum check
     {
-        const tree::value_type& config { root_.front() };
-        if(config.second.count(DEFAULT_NODE_NAME) > 1)
-            JET_THROW_CFG()
-                << "Duplicate default node in config source '" << source_name_ << '\'';
-    }
-    void check_no_default_subnode_duplicates() const
+        no_data_in_config_node,
+        no_data_in_default_node,
+        no_data_in_app_and_instance_node,
+        no_data_and_attribute_nodes,
+        no_default_node_duplicates,
+        no_default_subnode_duplicates,
+        no_default_instance_node,
+        no_direct_default_attributes,
+        no_app_node_duplicates,
+        no_instance_node_duplicates,
+        no_instance_subnode_duplicates,
+        no_error
+    };
+    //...returns stream for error message of the failed check (or dummy stream if error of
+    //...preceding check or the same check is already found)
+    std::ostream& fail(check failed_check)
     {
-        const tree::value_type& config { root_.front() };
-        const cassoc_tree_iter default_iter { config.second.find(DEFAULT_NODE_NAME) };
-        if(config.second.not_found() == default_iter)
-            return;
-
-        for(const tree::value_type& default_child : default_iter->second)
+        if(failed_check >= failed_check_)
         {
-            if(default_iter->second.count(default_child.first) > 1)
-                JET_THROW_CFG()
-                    << "Duplicate default node '" << default_child.first
-                    << "' in config source '" << source_name_ << '\'';
+            ignored_.str(std::string{});
+            return ignored_;
         }
+        failed_check_ = failed_check;
+        error_.str(std::string{});
+        return error_;
     }
-    void check_no_default_instance_node() const
-    {
-        const tree::value_type& config { root_.front() };
-        const cassoc_tree_iter default_iter { config.second.find(DEFAULT_NODE_NAME) };
-        if(config.second.not_found() == default_iter)
-            return;
-        for(const tree::value_type& node : default_iter->second)
+    void check_node_does_not_have_data_and_attribute(std::string& current_path, const tree& tree)
+    {//...'current_path' is used as a buffer, it's restored on return
+        if(!tree.empty() && !tree.data().empty())
+            fail(no_data_and_attribute_nodes)
+                << "Invalid element '" << current_path
+                << "' in config source '" << source_name_
+                << "' contains both value and child attributes";
+        const size_t path_size{current_path.size()};
+        for(const tree::value_type& node : tree)
         {
-            const std::string node_name { boost::to_lower_copy(node.first) };
-            if(node_name == INSTANCE_NODE_NAME)
-                JET_THROW_CFG()
-                    << "config source '" << source_name_
-                    << "' is invalid: '" DEFAULT_NODE_NAME "' node can not contain '"
-                    << node.first<< "' node";
+            current_path += NODE_DELIMITER;
+            current_path += node.first;
+            check_node_does_not_have_data_and_attribute(current_path, node.second);
+            current_path.resize(path_size);
         }
     }
-    void check_no_direct_default_attributes() const
+    void check_default_node(const tree& default_node)
     {
-        const tree::value_type& config { root_.front() };
-        const cassoc_tree_iter default_iter { config.second.find(DEFAULT_NODE_NAME) };
-        if(config.second.not_found() == default_iter)
-            return;
-        for(const tree::value_type& node : default_iter->second)
+        if(!default_node.data().empty())
+            fail(no_data_in_default_node)
+                << "Invalid data node '" << prune_string(default_node.data())
+                << "' under '" DEFAULT_NODE_NAME "' node in config source '" << source_name_ << '\'';
+        const detail::child_index default_names{default_node};
+        for(const tree::value_type& node : default_node)
         {
+            if(default_names.count(node.first) > 1)
+                fail(no_default_subnode_duplicates)
+                    << "Duplicate default node '" << node.first
+                    << "' in config source '" << source_name_ << '\'';
+            if(detail::iequals(node.first, INSTANCE_NODE_NAME))
+                fail(no_default_instance_node)
+                    << "config source '" << source_name_
+                    << "' is invalid: '" DEFAULT_NODE_NAME "' node can not contain '"
+                    << node.first<< "' node";
             if(!node.second.data().empty())
-                JET_THROW_CFG()
+                fail(no_direct_default_attributes)
                     << "config source '" << source_name_
                     << "' is invalid: '" DEFAULT_NODE_NAME
                     "' node can not contain direct properties. See '" DEFAULT_NODE_NAME "."
                     << node.first << "' property";
         }
     }
-    void check_no_app_node_duplicates() const
-    {
-        const tree::value_type& config { root_.front() };
-        for(const tree::value_type& node : config.second)
-        {
-            if(config.second.count(node.first) > 1)
-                JET_THROW_CFG()
-                    << "Duplicate node '" << node.first
-                    << "' in config source '" << source_name_ << '\'';
-        }
-    }
-    void check_no_instance_node_duplicates() const
+    void check_app_node(const std::string& app_name, const tree& app_node)
     {
-        const tree::value_type& config { root_.front() };
-        for(const tree::value_type& node : config.second)
+        if(!app_node.data().empty())
+            fail(no_data_in_app_and_instance_node)
+                << "Invalid data node '" << prune_string(app_node.data())
+                << "' under '" << app_name << "' node in config source '" << source_name_ << '\'';
+        bool has_instance_node{false};
+        for(const tree::value_type& node : app_node)
         {
-            check_no_instance_node_duplicates_impl(node.first, node.second);
-        }
-    }
-    void check_no_instance_subnode_duplicates() const
-    {
-        const tree::value_type& config { root_.front() };
-        for(const tree::value_type& node : config.second)
-        {
-            check_no_instance_subnode_duplicates_impl(node.first, node.second);
-        }
-    }
-private:
-    void check_node_does_not_have_data_and_attribute(const path& current_path, const tree& tree) const
-    {
-        if(!tree.empty() && !tree.data().empty())
-            JET_THROW_CFG()
-                << "Invalid element '" << current_path.dump()
-                << "' in config source '" << source_name_
-                << "' contains both value and child attributes";
-        for(const tree::value_type& node : tree)
-        {
-            const path node_path { current_path/path{node.first} };
-            check_node_does_not_have_data_and_attribute(node_path, node.second);
+            if(INSTANCE_NODE_NAME != node.first)
+                continue;
+            if(has_instance_node)
+            {
+                fail(no_instance_node_duplicates)
+                    << "Duplicate " INSTANCE_NODE_NAME " node under '" << app_name
+                    << "' node in config source '" << source_name_ << '\'';
+                break;
+            }
+            has_instance_node = true;
+            check_instance_node(app_name, node.second);
         }
     }
-    void check_no_instance_node_duplicates_impl(const std::string& app_name, const tree& app_node) const
+    void check_instance_node(const std::string& app_name, const tree& instance_node)
     {
-        if(DEFAULT_NODE_NAME == app_name)//...in fact this is not an application node
-            return;
-        if(app_node.count(INSTANCE_NODE_NAME) > 1)
-            JET_THROW_CFG()
-                << "Duplicate " INSTANCE_NODE_NAME " node under '" << app_name
-                << "' node in config source '" << source_name_ << '\'';
-    }
-    void check_no_instance_subnode_duplicates_impl(const std::string& app_name, const tree& app_node) const
-    {
-        if(DEFAULT_NODE_NAME == app_name)//...in fact this is not an application node
-            return;
-        const cassoc_tree_iter instance_iter { app_node.find(INSTANCE_NODE_NAME) };
-        if(app_node.not_found() == instance_iter)
-            return;
-        for(const tree::value_type& instance_subnode : instance_iter->second)
+        const detail::child_index instance_names{instance_node};
+        for(const tree::value_type& node : instance_node)
         {
-            if(instance_iter->second.count(instance_subnode.first) > 1)
-            {
-                std::string instance_name{app_name};
-                instance_name += INSTANCE_DELIMITER;
-                instance_name += instance_subnode.first;
-                JET_THROW_CFG()
-                    << "Duplicate node '" << instance_name << "' in config source '"
-                    << source_name_ << '\'';
-            }
+            if(!node.second.data().empty())
+                fail(no_data_in_app_and_instance_node)
+                    << "Invalid data node '" << prune_string(node.second.data())
+                    << "' under '" << app_name << INSTANCE_DELIMITER << node.first
+                    << "' node in config source '" << source_name_ << '\'';
+            if(instance_names.count(node.first) > 1)
+                fail(no_instance_subnode_duplicates)
+                    << "Duplicate node '" << app_name << INSTANCE_DELIMITER << node.first
+                    << "' in config source '" << source_name_ << '\'';
         }
     }
+    //...
     const std::string& source_name_;
     const tree& root_;
+    check failed_check_;
+    std::ostringstream error_, ignored_;
 };
 
 }//anonymous namespace
@@ -244,11 +234,13 @@ config_source::impl::impl(
     switch (format)
     {
         case config_source::xml:
-            PT::read_xml(
-                input,
-                root_,
-                PT::xml_parser::trim_whitespace | PT::xml_parser::no_comments);
-            normalize_xml_attributes(root_);
+        {
+            const std::string text{read_all(input)};
+            read_xml(text.data(), text.size(), std::string{});
+            break;
+        }
+        case config_source::json:
+            read_json(input, root_);
             break;
         default:
             JET_THROW_CFG() << "Parsing of config format " << format << " is not implemented";
@@ -265,11 +257,43 @@ config_source::impl::impl(
     switch (format)
     {
         case config_source::xml:
-            PT::read_xml(
-                filename,
-                root_,
-                PT::xml_parser::trim_whitespace | PT::xml_parser::no_comments);
-            normalize_xml_attributes(root_);
+        {
+            std::ifstream file{filename, std::ios::in | std::ios::binary};
+            if(!file)
+                JET_THROW_CFG() << "Couldn't open file '" << filename << '\'';
+            const std::string text{read_all(file)};
+            read_xml(text.data(), text.size(), filename);
+            break;
+        }
+        case config_source::json:
+        {
+            std::ifstream file{filename, std::ios::in | std::ios::binary};
+            if(!file)
+                JET_THROW_CFG() << "Couldn't open file '" << filename << '\'';
+            read_json(file, root_);
+            break;
+        }
+        default:
+            JET_THROW_CFG() << "Parsing of config format " << format << " is not implemented";
+    }
+    process_raw_tree(fname_style);
+}
+
+config_source::impl::impl(
+    const char* data,
+    size_t size,
+    const std::string& name,
+    config_source::input_format format,
+    config_source::file_name_style fname_style):
+    name_{name}
+{
+    switch (format)
+    {
+        case config_source::xml:
+            read_xml(data, size, std::string{});
+            break;
+        case config_source::json:
+            detail::read_json(data, data + size, root_);
             break;
         default:
             JET_THROW_CFG() << "Parsing of config format " << format << " is not implemented";
@@ -296,18 +320,7 @@ void config_source::impl::process_raw_tree(config_source::file_name_style fname_
     normalize_keywords(root_, fname_style);
     normalize_instance_delimiter(root_);
     
-    const tree_validator validator(name(), root_);
-    validator.check_no_data_in_config_node();
-    validator.check_no_data_in_default_node();
-    validator.check_no_data_in_app_and_instance_node();
-    validator.check_tree_does_not_have_data_and_attribute_nodes();
-    validator.check_no_default_node_duplicates();
-    validator.check_no_default_subnode_duplicates();
-    validator.check_no_default_instance_node();
-    validator.check_no_direct_default_attributes();
-    validator.check_no_app_node_duplicates();
-    validator.check_no_instance_node_duplicates();
-    validator.check_no_instance_subnode_duplicates();
+    tree_validator{name(), root_}.validate();
 }
 
 std::string config_source::impl::to_string(bool pretty) const
@@ -325,40 +338,20 @@ std::string config_source::impl::to_string(bool pretty) const
     return strm.str();
 }
 
-void config_source::impl::normalize_xml_attributes(tree& raw_tree) const
-{
-    if (raw_tree.empty())
+void config_source::impl::read_xml(const char* data, size_t size, const std::string& file_name)
+{//...attributes are normalized by parser, the raw tree with '<xmlattr>' nodes is never built
+    detail::read_xml(data, data + size, file_name, name(), root_);
+    if (root_.empty())
         JET_THROW_CFG() << "Config source '" << name() << "' is empty";
-    
-    normalize_xml_attributes_impl(path(), raw_tree);
-}
-
-void config_source::impl::normalize_xml_attributes_impl(const path& current_path, tree& raw_tree) const
-{
-    const tree_iter end{raw_tree.end()};
-    for(tree_iter iter = raw_tree.begin(); end != iter;)
-    {
-        if("<xmlattr>" == iter->first)
-        {
-            copy_unique_children(current_path, iter->second, raw_tree);
-            iter = raw_tree.erase(iter);
-        }
-        else
-        {
-            normalize_xml_attributes_impl(current_path/path{iter->first}, iter->second);
-            ++iter;
-        }
-    }
 }
 
 void config_source::impl::normalize_root_node(tree& raw_tree) const
 {
-    if(raw_tree.size() == 1 && ROOT_NODE_NAME == boost::to_lower_copy(raw_tree.front().first))
+    if(raw_tree.size() == 1 && detail::iequals(raw_tree.front().first, ROOT_NODE_NAME))
         return;//...this tree is already normalized
     for(const tree::value_type& child : raw_tree)
     {
-        const std::string& child_name = child.first;
-        if(ROOT_NODE_NAME == boost::to_lower_copy(child_name))
+        if(detail::iequals(child.first, ROOT_NODE_NAME))
             JET_THROW_CFG()
                 << "Invalid config source '" << name()
                 << "'. '" ROOT_NODE_NAME "' must be root node";
@@ -384,7 +377,7 @@ void config_source::impl::normalize_keywords(
     tree& root, config_source::file_name_style fname_style) const
 {
     const std::string& root_name { root.front().first };
-    assert(ROOT_NODE_NAME == boost::to_lower_copy(root_name));
+    assert(detail::iequals(root_name, ROOT_NODE_NAME));
     if(ROOT_NODE_NAME != root_name)
         rename_node(root, root.begin(), ROOT_NODE_NAME);
     tree& config_node { root.front().second };
@@ -397,7 +390,7 @@ void config_source::impl::normalize_keywords(
 tree_iter config_source::impl::normalize_keywords_impl(
     tree& parent, const tree_iter& child_iter, config_source::file_name_style fname_style) const
 {
-    if(DEFAULT_NODE_NAME == boost::to_lower_copy(child_iter->first))
+    if(detail::iequals(child_iter->first, DEFAULT_NODE_NAME))
     {
         if(DEFAULT_NODE_NAME != child_iter->first)
             return rename_node(parent, child_iter, DEFAULT_NODE_NAME);
@@ -408,17 +401,17 @@ tree_iter config_source::impl::normalize_keywords_impl(
         for(tree_iter iter = app_node.begin(); app_node.end() != iter; ++iter)
         {
             const std::string& node_name { iter->first };
-            if(INSTANCE_NODE_NAME == boost::to_lower_copy(node_name))
+            if(detail::iequals(node_name, INSTANCE_NODE_NAME))
             {
                 if(INSTANCE_NODE_NAME != node_name)
                     iter = rename_node(app_node, iter, INSTANCE_NODE_NAME);
             }
         }
-        if(config_source::case_insensitive == fname_style)
-        {
-            const std::string low_case_name { boost::to_lower_copy(child_iter->first) };
-            if(child_iter->first != low_case_name)
-                return rename_node(parent, child_iter, low_case_name);
+        if(config_source::case_insensitive == fname_style && detail::has_upper_case(child_iter->first))
+        {//...name is copied and folded only if it's not in lower case already
+            std::string low_case_name { child_iter->first };
+            detail::to_lower(low_case_name);
+            return rename_node(parent, child_iter, low_case_name);
         }
     }
     return child_iter;
@@ -462,7 +455,7 @@ tree_iter config_source::impl::normalize_instance_delimiter_impl(
             << "Invalid '" INSTANCE_DELIMITER "' in element '" << child_name
             << "' in config source '" << name()
             << "'. Expected format 'app_name" INSTANCE_DELIMITER "instance_name'";
-    if(boost::to_lower_copy(app_name) == DEFAULT_NODE_NAME)
+    if(detail::iequals(app_name, DEFAULT_NODE_NAME))
         JET_THROW_CFG()
             << "Default node '" << child_name
             << "' can't have instance. Found in config source '" << name() << '\'';
@@ -479,16 +472,18 @@ tree_iter config_source::impl::normalize_instance_delimiter_impl(
     return parent.erase(child_iter);
 }
 
-void config_source::impl::copy_unique_children(const path& current_path, const tree& from, tree& to) const
-{
-    for(const tree::value_type& node : boost::adaptors::reverse(from))
-    {
-        if(from.count(node.first) > 1)
-            JET_THROW_CFG()
-                << "Duplicate definition of attribute '" << (current_path/path(node.first)).dump()
-                << "' in config '" << name() << '\'';
-        to.push_front(node);
-    }
+std::size_t tree_memory_usage(const tree& root)
+{//...ptree allocates its container with header node, every child is a node of container with
+ //...two indexes (sequenced: 2 links, ordered: 3 links)
+    const std::size_t node_size{sizeof(value_type) + 5 * sizeof(void*)};
+    const auto string_usage = [](const std::string& str) -> std::size_t
+        {
+            return str.capacity() >= sizeof(std::string) ? str.capacity() + 1 : 0;
+        };
+    std::size_t result{node_size + string_usage(root.data())};
+    for(const value_type& child : root)
+        result += node_size + string_usage(child.first) + tree_memory_usage(child.second);
+    return result;
 }
 
 config_source::config_source(std::unique_ptr<impl> impl): impl_(std::move(impl)) {}
@@ -511,14 +506,18 @@ const std::string& config_source::name() const
     return impl_->name();
 }
 
+std::size_t config_source::memory_usage() const
+{
+    return impl_->memory_usage();
+}
+
 config_source::config_source(const config_source& other):
-    impl_{new impl{*other.impl_}}
+    impl_{other.impl_}
 {}
 
 config_source& config_source::operator=(const config_source& other)
 {
-    std::unique_ptr<impl> tmp{new impl{*other.impl_}};
-    impl_.swap(tmp);
+    impl_ = other.impl_;
     return *this;
 }
 
@@ -534,8 +533,7 @@ config_source& config_source::operator=(config_source&& other)
 
 config_source config_source::from_string::create() try
 {
-    std::stringstream strm { source_ };
-    return std::unique_ptr<impl>{new impl{strm, name_, fmt_, name_style_}};
+    return std::unique_ptr<impl>{new impl{source_.data(), source_.size(), name_, fmt_, name_style_}};
 }
 catch(const std::exception& ex)
 {
@@ -553,6 +551,27 @@ catch(const std::exception& ex)
         << "Couldn't parse config '" << name_ << '\'';
 }
 
+config_source config_source::from_buffer::create() try
+{
+    return std::unique_ptr<impl>{new impl{data_, size_, name_, fmt_, name_style_}};
+}
+catch(const std::exception& ex)
+{
+    JET_THROW_CFG()
+        << "Couldn't parse config '" << name_ << '\'';
+}
+
+config_source config_source::from_mapped_file::create() try
+{
+    const detail::mapped_file file{filename_};
+    return std::unique_ptr<impl>{new impl{file.data(), file.size(), filename_, fmt_, name_style_}};
+}
+catch(const std::exception& ex)
+{
+    JET_THROW_CFG()
+        << "Couldn't parse config '" << filename_ << '\'';
+}
+
 config_source config_source::from_file::create() try
 {
     return std::unique_ptr<impl>{new impl{filename_, fmt_, name_style_}};
@@ -606,5 +625,66 @@ catch(const std::exception& ex)
         << "Couldn't create configuration from '" << source_ << '\'';
 }
 
+namespace
+{
+//...joins started threads when it goes out of scope, so exception thrown while other threads are
+//...being started doesn't destroy joinable threads (which would call std::terminate)
+class thread_joiner: boost::noncopyable
+{
+public:
+    explicit thread_joiner(std::vector<std::thread>& threads): threads_(threads) {}
+    ~thread_joiner()
+    {
+        for(std::thread& thread : threads_)
+        {
+            if(thread.joinable())
+                thread.join();
+        }
+    }
+private:
+    std::vector<std::thread>& threads_;
+};
+}//anonymous namespace
+
+std::vector<config_source> config_source_batch::create(std::size_t threads) const
+{
+    std::vector<std::unique_ptr<config_source>> sources(factories_.size());
+    std::vector<std::exception_ptr> errors(factories_.size());
+    std::atomic<std::size_t> next{0};
+    const auto worker = [this, &sources, &errors, &next]()
+    {
+        for(std::size_t index = next++; index < factories_.size(); index = next++)
+        {
+            try
+            {
+                sources[index].reset(new config_source{factories_[index]()});
+            }
+            catch(...)
+            {
+                errors[index] = std::current_exception();
+            }
+        }
+    };
+    if(!threads)
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    threads = std::min(threads, factories_.size());
+    std::vector<std::thread> workers;
+    {
+        const thread_joiner joiner{workers};
+        for(std::size_t i = 1; i < threads; ++i)
+            workers.emplace_back(worker);
+        worker();
+    }
+
+    std::vector<config_source> result;
+    result.reserve(sources.size());
+    for(std::size_t index = 0; index < sources.size(); ++index)
+    {
+        if(errors[index])
+            std::rethrow_exception(errors[index]);
+        result.push_back(std::move(*sources[index]));
+    }
+    return result;
+}
 
 }//namespace jet
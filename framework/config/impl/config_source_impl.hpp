@@ -11,6 +11,8 @@
 
 #include "config_source.hpp"
 #include <boost/property_tree/ptree.hpp>
+#include <boost/noncopyable.hpp>
+#include <cstddef>
 
 #define ROOT_NODE_NAME     "config"
 #define DEFAULT_NODE_NAME  "default"
@@ -21,7 +23,11 @@
 namespace jet
 {
 
-class config_source::impl
+//...estimated bytes of heap owned by tree: node allocations of child containers and
+//...key/data strings which don't fit into small string buffer
+std::size_t tree_memory_usage(const boost::property_tree::ptree& root);
+
+class config_source::impl: boost::noncopyable
 {
 public:
     impl(
@@ -33,6 +39,12 @@ public:
         const std::string& filename,
         config_source::input_format format,
         config_source::file_name_style fname_style);
+    impl(
+        const char* data,
+        std::size_t size,
+        const std::string& name,
+        config_source::input_format format,
+        config_source::file_name_style fname_style);
     impl(
         const boost::property_tree::ptree& root,
         const std::string& name,
@@ -40,21 +52,15 @@ public:
     std::string to_string(bool pretty) const;
     const std::string& name() const { return name_; }
     const boost::property_tree::ptree& get_root() const { return root_; }
+    std::size_t memory_usage() const { return tree_memory_usage(root_); }
 private:
     void process_raw_tree(config_source::file_name_style fname_style);
-    void normalize_xml_attributes(boost::property_tree::ptree& raw_tree) const;
-    void normalize_xml_attributes_impl(
-        const boost::property_tree::path& current_path,
-        boost::property_tree::ptree& raw_tree) const;
+    void read_xml(const char* data, std::size_t size, const std::string& file_name);
     void normalize_root_node(boost::property_tree::ptree& raw_tree) const;
     void normalize_instance_delimiter(boost::property_tree::ptree& raw_tree) const;
     boost::property_tree::ptree::iterator normalize_instance_delimiter_impl(
         boost::property_tree::ptree& parent,
         const boost::property_tree::ptree::iterator& child) const;
-    void copy_unique_children(
-        const boost::property_tree::path& current_path,
-        const boost::property_tree::ptree& from,
-        boost::property_tree::ptree& to) const;
     void normalize_keywords(
         boost::property_tree::ptree& tree,
         config_source::file_name_style fname_style) const;
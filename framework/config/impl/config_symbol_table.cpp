@@ -0,0 +1,160 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_symbol_table.hpp"
+#include "config_child_index.hpp"
+#include "config_throw.hpp"
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+namespace jet
+{
+namespace detail
+{
+
+namespace
+{
+using symbol_map = std::unordered_map<boost::string_ref, symbol_table::symbol, name_hash>;
+//...estimated heap size of interned name besides its characters: node of the map and its bucket
+const std::size_t name_overhead{sizeof(symbol_map::value_type) + 3 * sizeof(void*)};
+}//anonymous namespace
+
+class symbol_table::shard: boost::noncopyable
+{
+public:
+    std::mutex mutex;
+    symbol_map symbols;
+};
+
+const std::size_t symbol_table::chunk_bits;
+const std::size_t symbol_table::chunk_size;
+const std::size_t symbol_table::max_chunks;
+const std::size_t symbol_table::shard_count;
+
+symbol_table& symbol_table::instance()
+{//...it's never destroyed: configs with static storage duration may outlive it otherwise
+    static symbol_table* const table{new symbol_table};
+    return *table;
+}
+
+symbol_table::symbol_table(): size_{0}, memory_usage_{0}, shards_{new shard[shard_count]}, next_{0}
+{
+    for(std::atomic<entry*>& chunk : chunks_)
+        chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+symbol_table::~symbol_table()
+{
+    for(std::atomic<entry*>& chunk : chunks_)
+    {
+        if(entry* const entries = chunk.load())
+        {
+            for(std::size_t index = 0; index < chunk_size; ++index)
+                delete[] entries[index].data;
+            delete[] entries;
+        }
+    }
+    delete[] shards_;
+}
+
+symbol_table::symbol symbol_table::intern(boost::string_ref str)
+{
+    shard& owner(shards_[name_hash{}(str) % shard_count]);
+    std::lock_guard<std::mutex> guard{owner.mutex};
+    const auto found = owner.symbols.find(str);
+    if(owner.symbols.end() != found)
+    {
+        ++get(found->second).references;
+        return found->second;
+    }
+    const symbol sym{allocate()};
+    entry& result(get(sym));
+    char* const data{new char[str.size()]};
+    std::memcpy(data, str.data(), str.size());
+    result.data = data;
+    result.size = str.size();
+    result.references = 1;
+    try
+    {
+        owner.symbols.emplace(boost::string_ref{result.data, result.size}, sym);
+    }
+    catch(...)
+    {
+        delete[] data;
+        result.data = nullptr;
+        result.size = 0;
+        std::lock_guard<std::mutex> free_guard{free_mutex_};
+        free_.push_back(sym);
+        throw;
+    }
+    size_.fetch_add(1, std::memory_order_relaxed);
+    memory_usage_.fetch_add(str.size() + name_overhead, std::memory_order_relaxed);
+    return sym;
+}
+
+void symbol_table::release(symbol sym)
+{
+    entry& released(get(sym));
+    const boost::string_ref str{released.data, released.size};
+    shard& owner(shards_[name_hash{}(str) % shard_count]);
+    {
+        std::lock_guard<std::mutex> guard{owner.mutex};
+        if(--released.references)
+            return;
+        owner.symbols.erase(str);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        memory_usage_.fetch_sub(str.size() + name_overhead, std::memory_order_relaxed);
+        delete[] released.data;
+        released.data = nullptr;
+        released.size = 0;
+    }
+    std::lock_guard<std::mutex> guard{free_mutex_};
+    free_.push_back(sym);
+}
+
+symbol_table::symbol symbol_table::allocate()
+{//...released symbol is reused first, chunk is allocated by the first symbol which needs it
+    std::lock_guard<std::mutex> guard{free_mutex_};
+    if(!free_.empty())
+    {
+        const symbol sym{free_.back()};
+        free_.pop_back();
+        return sym;
+    }
+    if(next_ >= chunk_size * max_chunks)
+        JET_THROW_CFG() << "Too many config key names: " << next_;
+    std::atomic<entry*>& chunk(chunks_[next_ >> chunk_bits]);
+    if(!chunk.load(std::memory_order_relaxed))
+    {
+        chunk.store(new entry[chunk_size](), std::memory_order_release);
+        memory_usage_.fetch_add(chunk_size * sizeof(entry), std::memory_order_relaxed);
+    }
+    if(free_.capacity() <= next_)//...so symbol is always put back without allocation
+        free_.reserve(2 * next_ + 16);
+    return next_++;
+}
+
+symbol_references::~symbol_references()
+{
+    symbol_table& table(symbol_table::instance());
+    for(const symbol_table::symbol sym : symbols_)
+        table.release(sym);
+}
+
+symbol_table::symbol symbol_references::intern(boost::string_ref str)
+{
+    if(symbols_.size() == symbols_.capacity())//...so interned symbol is always kept
+        symbols_.reserve(2 * symbols_.size() + 16);
+    const symbol_table::symbol sym{symbol_table::instance().intern(str)};
+    symbols_.push_back(sym);
+    return sym;
+}
+
+}//namespace detail
+}//namespace jet
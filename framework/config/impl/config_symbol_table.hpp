@@ -0,0 +1,91 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_SYMBOL_TABLE_HEADER_GUARD
+#define JET_CONFIG_CONFIG_SYMBOL_TABLE_HEADER_GUARD
+
+#include <boost/utility/string_ref.hpp>
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace jet
+{
+namespace detail
+{
+
+//...process-wide table of interned key names (single parts of paths, not whole paths), it's shared
+//...by all configs, so every distinct name is stored once and names are compared as integers.
+//...Symbols are reference counted: name is released (and its symbol is reused) when the last
+//...owner releases it, so the table keeps only names of alive configs (only the array of entries
+//...stays at its peak size, its free entries are reused by new names).
+//...intern() and release() are thread-safe (names are spread over independently locked shards),
+//...str() is lock-free and valid while the caller holds a reference to the symbol
+class symbol_table: boost::noncopyable
+{
+public:
+    using symbol = std::uint32_t;
+
+    static symbol_table& instance();
+
+    symbol intern(boost::string_ref str);//...adds reference
+    void release(symbol sym);
+    boost::string_ref str(symbol sym) const
+    {
+        const entry& found(get(sym));
+        return {found.data, found.size};
+    }
+    std::size_t size() const { return size_.load(std::memory_order_relaxed); }//...number of names
+    std::size_t memory_usage() const { return memory_usage_.load(std::memory_order_relaxed); }
+private:
+    static const std::size_t chunk_bits{12}, chunk_size{std::size_t{1} << chunk_bits}, max_chunks{4096};
+    static const std::size_t shard_count{16};
+    struct entry
+    {
+        const char* data;
+        std::size_t size;
+        std::size_t references;//...guarded by mutex of the shard which owns the name
+    };
+    class shard;
+
+    symbol_table();
+    ~symbol_table();
+    entry& get(symbol sym) const
+    {
+        entry* const chunk{chunks_[sym >> chunk_bits].load(std::memory_order_acquire)};
+        return chunk[sym & (chunk_size - 1)];
+    }
+    symbol allocate();
+    //...
+    std::atomic<entry*> chunks_[max_chunks];
+    std::atomic<std::size_t> size_, memory_usage_;
+    shard* shards_;
+    std::mutex free_mutex_;
+    std::vector<symbol> free_;//...released symbols
+    symbol next_;//...the first symbol which has never been used, guarded by 'free_mutex_'
+};
+
+//...symbols interned by one owner, they are released when it's destroyed
+class symbol_references: boost::noncopyable
+{
+public:
+    symbol_references() {}
+    ~symbol_references();
+    symbol_table::symbol intern(boost::string_ref str);
+    std::size_t memory_usage() const { return symbols_.capacity() * sizeof(symbol_table::symbol); }
+private:
+    std::vector<symbol_table::symbol> symbols_;
+};
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_SYMBOL_TABLE_HEADER_GUARD*/
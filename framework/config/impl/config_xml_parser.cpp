@@ -0,0 +1,407 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "config_xml_parser.hpp"
+#include "config_child_index.hpp"
+#include "config_throw.hpp"
+#include <boost/noncopyable.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using tree             = boost::property_tree::ptree;
+using value_type       = tree::value_type;
+
+namespace jet
+{
+namespace detail
+{
+
+namespace
+{
+
+inline bool is_space(char c)
+{
+    return ' ' == c || '\t' == c || '\n' == c || '\r' == c;
+}
+
+inline bool is_name_char(char c)
+{
+    return !is_space(c) && '/' != c && '>' != c && '?' != c;
+}
+
+inline bool is_attribute_name_char(char c)
+{
+    return is_name_char(c) && '<' != c && '=' != c && '!' != c;
+}
+
+//...reads document and calls handler for every element, attribute and text of element:
+//...start_element(name), attribute(name, value), end_attributes(), data(text), end_element().
+//...Nesting is tracked without recursion, so depth of document is not limited by stack
+template<typename handler_type>
+class xml_reader: boost::noncopyable
+{
+public:
+    xml_reader(const char* begin, const char* end, const std::string& file_name, handler_type& handler):
+        begin_{begin},
+        pos_{begin},
+        end_{std::find(begin, end, '\0')},//...the same as zero terminated text is parsed
+        file_name_(file_name),
+        handler_(handler)
+    {}
+    void read()
+    {
+        static const char bom[]{"\xEF\xBB\xBF"};
+        if(end_ - pos_ >= 3 && 0 == std::memcmp(pos_, bom, 3))
+            pos_ += 3;
+        size_t depth{0};
+        for(;;)
+        {
+            if(!depth)
+            {
+                skip_space();
+                if(end_ == pos_)
+                    return;
+                if('<' != *pos_)
+                    error("expected <");
+                ++pos_;
+            }
+            else
+            {
+                read_data();
+                ++pos_;//...'<'
+                if(consume('/'))
+                {
+                    skip_name();
+                    skip_space();
+                    if(!consume('>'))
+                        error("expected >");
+                    handler_.end_element();
+                    --depth;
+                    continue;
+                }
+            }
+            if(consume('?'))
+                skip_to("?>");
+            else if(consume('!'))
+                read_special_node();
+            else if(read_element())
+                ++depth;
+        }
+    }
+private:
+    bool read_element()
+    {//...'<' is already consumed, returns false for empty element
+        const char* const name{pos_};
+        skip_name();
+        if(name == pos_)
+            error("expected element name");
+        handler_.start_element(boost::string_ref{name, static_cast<size_t>(pos_ - name)});
+        skip_space();
+        while(end_ != pos_ && is_attribute_name_char(*pos_))
+            read_attribute();
+        handler_.end_attributes();
+        if(consume('>'))
+            return true;
+        if(consume('/') && consume('>'))
+        {
+            handler_.end_element();
+            return false;
+        }
+        error("expected >");
+    }
+    void read_attribute()
+    {
+        const char* const name{pos_};
+        while(end_ != pos_ && is_attribute_name_char(*pos_))
+            ++pos_;
+        const boost::string_ref attr_name{name, static_cast<size_t>(pos_ - name)};
+        skip_space();
+        if(!consume('='))
+            error("expected =");
+        skip_space();
+        const char quote{end_ != pos_ ? *pos_ : '\0'};
+        if('\'' != quote && '"' != quote)
+            error("expected ' or \"");
+        ++pos_;
+        text_.clear();
+        for(;;)
+        {
+            const char* const start{pos_};
+            while(end_ != pos_ && quote != *pos_ && '&' != *pos_)
+                ++pos_;
+            text_.append(start, pos_);
+            if(end_ == pos_)
+                error("expected ' or \"");
+            if(quote == *pos_)
+                break;
+            read_reference();
+        }
+        ++pos_;
+        handler_.attribute(attr_name, text_);
+        skip_space();
+    }
+    void read_data()
+    {//...text up to the next '<' with leading and trailing whitespace trimmed and runs of whitespace
+     //...replaced by one space
+        skip_space();
+        if(end_ != pos_ && '<' == *pos_)
+            return;
+        text_.clear();
+        for(;;)
+        {
+            const char* const start{pos_};
+            while(end_ != pos_ && '<' != *pos_ && '&' != *pos_ && !is_space(*pos_))
+                ++pos_;
+            text_.append(start, pos_);
+            if(end_ == pos_)
+                error("unexpected end of data");
+            if('<' == *pos_)
+                break;
+            if('&' == *pos_)
+                read_reference();
+            else
+            {
+                text_ += ' ';
+                skip_space();
+            }
+        }
+        if(!text_.empty() && ' ' == text_.back())
+            text_.pop_back();
+        handler_.data(text_);
+    }
+    void read_special_node()
+    {//...'<!' is already consumed
+        if(starts_with("--"))
+        {
+            pos_ += 2;
+            skip_to("-->");
+        }
+        else if(starts_with("[CDATA["))
+        {
+            pos_ += 7;
+            const char* const start{pos_};
+            skip_to("]]>");
+            handler_.data(boost::string_ref{start, static_cast<size_t>(pos_ - 3 - start)});
+        }
+        else if(starts_with("DOCTYPE") && end_ - pos_ > 7 && is_space(pos_[7]))
+        {
+            pos_ += 8;
+            skip_doctype();
+        }
+        else
+            skip_to(">");
+    }
+    void skip_doctype()
+    {
+        for(;;)
+        {
+            if(end_ == pos_)
+                error("unexpected end of data");
+            const char c{*pos_++};
+            if('>' == c)
+                return;
+            if('[' != c)
+                continue;
+            for(size_t depth = 1; depth;)
+            {
+                if(end_ == pos_)
+                    error("unexpected end of data");
+                const char nested{*pos_++};
+                if('[' == nested)
+                    ++depth;
+                else if(']' == nested)
+                    --depth;
+            }
+        }
+    }
+    void read_reference()
+    {//...the same references as in property_tree: unknown ones are kept as is
+        static const struct { const char* name; char value; } entities[]{
+            {"&amp;", '&'}, {"&apos;", '\''}, {"&quot;", '"'}, {"&gt;", '>'}, {"&lt;", '<'}};
+        for(const auto& entity : entities)
+        {
+            if(starts_with(entity.name))
+            {
+                text_ += entity.value;
+                pos_ += std::strlen(entity.name);
+                return;
+            }
+        }
+        if(!starts_with("&#"))
+        {
+            text_ += *pos_++;
+            return;
+        }
+        pos_ += 2;
+        unsigned long code{};
+        if(consume('x'))
+        {
+            for(int digit; end_ != pos_ && (digit = hex_digit(*pos_)) >= 0; ++pos_)
+                code = code * 16 + static_cast<unsigned long>(digit);
+        }
+        else
+        {
+            for(; end_ != pos_ && *pos_ >= '0' && *pos_ <= '9'; ++pos_)
+                code = code * 10 + static_cast<unsigned long>(*pos_ - '0');
+        }
+        if(code > 0x10FFFF)
+            error("invalid numeric character entity");
+        append_code_point(code);
+        if(!consume(';'))
+            error("expected ;");
+    }
+    void append_code_point(unsigned long code)
+    {
+        if(code < 0x80)
+            text_ += static_cast<char>(code);
+        else if(code < 0x800)
+        {
+            text_ += static_cast<char>(0xC0 | (code >> 6));
+            text_ += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else if(code < 0x10000)
+        {
+            text_ += static_cast<char>(0xE0 | (code >> 12));
+            text_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text_ += static_cast<char>(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            text_ += static_cast<char>(0xF0 | (code >> 18));
+            text_ += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+            text_ += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            text_ += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+    static int hex_digit(char c)
+    {
+        if(c >= '0' && c <= '9')
+            return c - '0';
+        if(c >= 'a' && c <= 'f')
+            return c - 'a' + 10;
+        if(c >= 'A' && c <= 'F')
+            return c - 'A' + 10;
+        return -1;
+    }
+    void skip_to(const char* terminator)
+    {//...skips everything up to and including 'terminator'
+        const size_t size{std::strlen(terminator)};
+        for(; !starts_with(terminator); ++pos_)
+        {
+            if(end_ == pos_)
+                error("unexpected end of data");
+        }
+        pos_ += size;
+    }
+    void skip_name()
+    {
+        while(end_ != pos_ && is_name_char(*pos_))
+            ++pos_;
+    }
+    void skip_space()
+    {
+        while(end_ != pos_ && is_space(*pos_))
+            ++pos_;
+    }
+    bool starts_with(const char* str) const
+    {
+        const size_t size{std::strlen(str)};
+        return static_cast<size_t>(end_ - pos_) >= size && 0 == std::memcmp(pos_, str, size);
+    }
+    bool consume(char c)
+    {
+        if(end_ == pos_ || c != *pos_)
+            return false;
+        ++pos_;
+        return true;
+    }
+    void error[[noreturn]](const char* message) const
+    {
+        JET_THROW_CFG()
+            << (file_name_.empty() ? "<unspecified file>" : file_name_.c_str())
+            << '(' << std::count(begin_, pos_, '\n') + 1 << "): " << message;
+    }
+    //...
+    const char* const begin_;
+    const char* pos_;
+    const char* const end_;
+    const std::string& file_name_;
+    handler_type& handler_;
+    std::string text_;
+};
+
+//...builds tree directly in normalized form: attributes are pushed as child nodes
+class tree_builder: boost::noncopyable
+{
+public:
+    tree_builder(tree& root, const std::string& source_name): source_name_(source_name)
+    {
+        stack_.push_back(&root);
+    }
+    void start_element(boost::string_ref name)
+    {
+        value_type& element{*stack_.back()->push_back({name.to_string(), tree{}})};
+        names_.push_back(&element.first);
+        stack_.push_back(&element.second);
+    }
+    void attribute(boost::string_ref name, const std::string& value)
+    {
+        stack_.back()->push_back({name.to_string(), tree{value}});
+    }
+    void end_attributes()
+    {
+        const tree& element{*stack_.back()};
+        if(element.size() < 2)
+            return;
+        const child_index names{element};
+        for(const value_type& attr : element)
+        {
+            if(names.count(attr.first) > 1)
+            {
+                std::string attr_path;
+                for(const std::string* name : names_)
+                    attr_path += *name + '.';
+                JET_THROW_CFG()
+                    << "Duplicate definition of attribute '" << attr_path << attr.first
+                    << "' in config '" << source_name_ << '\'';
+            }
+        }
+    }
+    void data(boost::string_ref text)
+    {
+        stack_.back()->data().append(text.data(), text.size());
+    }
+    void end_element()
+    {
+        stack_.pop_back();
+        names_.pop_back();
+    }
+private:
+    const std::string& source_name_;
+    std::vector<tree*> stack_;
+    std::vector<const std::string*> names_;
+};
+
+}//anonymous namespace
+
+void read_xml(
+    const char* begin,
+    const char* end,
+    const std::string& file_name,
+    const std::string& source_name,
+    tree& root)
+{
+    tree local;
+    tree_builder builder{local, source_name};
+    xml_reader<tree_builder>{begin, end, file_name, builder}.read();
+    root.swap(local);
+}
+
+}//namespace detail
+}//namespace jet
@@ -0,0 +1,36 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_CONFIG_XML_PARSER_HEADER_GUARD
+#define JET_CONFIG_CONFIG_XML_PARSER_HEADER_GUARD
+
+#include <boost/property_tree/ptree.hpp>
+#include <string>
+
+namespace jet
+{
+namespace detail
+{
+
+//...single pass event-driven XML reader which builds the tree with attributes already normalized:
+//...attributes are child nodes which precede child elements, so there are no '<xmlattr>' nodes.
+//...It follows the rules property_tree XML parser has with trimmed whitespace and no comments
+//...(text is trimmed, runs of whitespace are replaced by space, declarations, comments and
+//...DOCTYPE are skipped) and reports errors the same way: "file_name(line): message".
+//...'source_name' is used in the error about duplicate attributes
+void read_xml(
+    const char* begin,
+    const char* end,
+    const std::string& file_name,
+    const std::string& source_name,
+    boost::property_tree::ptree& root);
+
+}//namespace detail
+}//namespace jet
+
+#endif /*JET_CONFIG_CONFIG_XML_PARSER_HEADER_GUARD*/
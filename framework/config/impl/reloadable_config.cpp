@@ -0,0 +1,253 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "reloadable_config.hpp"
+#include "config_source_impl.hpp"
+#include "config_throw.hpp"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+
+namespace jet
+{
+
+namespace
+{
+
+struct config_version: boost::noncopyable
+{
+    config_version(const config& cfg, std::uint64_t number): cfg{cfg}, number{number} {}
+    const config cfg;
+    const std::uint64_t number;
+};
+
+}//anonymous namespace
+
+//...hazard pointer: version which can't be destroyed while snapshot refers to it.
+//...Hazards are reused by snapshots and they live as long as reloadable_config
+struct reloadable_config::hazard: boost::noncopyable
+{
+    std::atomic<const config_version*> pointer{nullptr};
+    std::atomic<bool> busy{true};
+    hazard* next{nullptr};
+};
+
+class reloadable_config::impl: boost::noncopyable
+{
+public:
+    impl(const std::string& app_name, const std::string& instance_name, const source_loader& loader):
+        app_name_{app_name},
+        instance_name_{instance_name},
+        loader_{loader},
+        current_{load(1)},
+        version_{1},
+        hazards_{nullptr}
+    {}
+    ~impl()
+    {
+        delete current_.load();
+        for(const config_version* retired : retired_)
+            delete retired;
+        for(hazard* iter = hazards_.load(); iter;)
+        {
+            hazard* const next{iter->next};
+            delete iter;
+            iter = next;
+        }
+    }
+    void reload()
+    {
+        std::lock_guard<std::mutex> guard{reload_mutex_};
+        const config_version* const next{load(version_.load() + 1)};
+        const config_version* const previous{current_.exchange(next)};
+        retired_.push_back(previous);
+        version_.store(next->number);
+        notify(previous->cfg, next->cfg);
+        reclaim();
+    }
+    subscription_id subscribe(const std::string& path, const change_callback& callback)
+    {
+        std::lock_guard<std::mutex> guard{subscriptions_mutex_};
+        const subscription_id id{++last_subscription_id_};
+        subscriptions_[path][id] = callback;
+        return id;
+    }
+    void unsubscribe(subscription_id id)
+    {
+        std::lock_guard<std::mutex> guard{subscriptions_mutex_};
+        for(auto iter = subscriptions_.begin(); subscriptions_.end() != iter; ++iter)
+        {
+            if(iter->second.erase(id))
+            {
+                if(iter->second.empty())
+                    subscriptions_.erase(iter);
+                return;
+            }
+        }
+    }
+    std::uint64_t version() const { return version_.load(); }
+    hazard& acquire_hazard() const
+    {
+        for(hazard* iter = hazards_.load(std::memory_order_acquire); iter; iter = iter->next)
+        {
+            if(!iter->busy.load(std::memory_order_relaxed) && !iter->busy.exchange(true, std::memory_order_acquire))
+                return *iter;
+        }
+        hazard* const result{new hazard{}};
+        result->next = hazards_.load(std::memory_order_relaxed);
+        while(!hazards_.compare_exchange_weak(
+            result->next, result, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        return *result;
+    }
+    const config_version& protect(hazard& h) const
+    {//...current version has to be re-read after it's published in hazard: reload() could retire it
+     //...(and miss the hazard) between the first read and publishing
+        const config_version* current{current_.load()};
+        for(;;)
+        {
+            h.pointer.store(current);
+            const config_version* const check{current_.load()};
+            if(check == current)
+                return *current;
+            current = check;
+        }
+    }
+private:
+    config_version* load(std::uint64_t number) const try
+    {
+        config cfg{app_name_, instance_name_};
+        for(const config_source& source : loader_())
+            cfg << source;
+        cfg << lock;
+        return new config_version{cfg, number};
+    }
+    catch(const std::exception& ex)
+    {
+        std::string name{app_name_};
+        if(!instance_name_.empty())
+            name += INSTANCE_DELIMITER + instance_name_;
+        JET_THROW_CFG() << "Couldn't load version " << number << " of config '" << name << '\'';
+    }
+    void notify(const config& previous, const config& next) const
+    {//...callbacks are called without lock, so they may subscribe and unsubscribe
+        {
+            std::lock_guard<std::mutex> guard{subscriptions_mutex_};
+            if(subscriptions_.empty())
+                return;
+        }
+        const config_changes changes{diff(previous, next)};
+        std::vector<std::pair<const config_change*, change_callback>> calls;
+        {
+            std::lock_guard<std::mutex> guard{subscriptions_mutex_};
+            for(const config_change& change : changes)
+            {
+                add_calls(change.path, change, calls);
+                for(size_t pos = change.path.size(); pos > 0;)
+                {
+                    pos = change.path.rfind(NODE_DELIMITER[0], pos - 1);
+                    if(std::string::npos == pos)
+                        break;
+                    add_calls(change.path.substr(0, pos) + NODE_DELIMITER "*", change, calls);
+                }
+                add_calls("*", change, calls);
+            }
+        }
+        for(const auto& call : calls)
+            call.second(*call.first);
+    }
+    void add_calls(
+        const std::string& path,
+        const config_change& change,
+        std::vector<std::pair<const config_change*, change_callback>>& calls) const
+    {
+        const auto iter = subscriptions_.find(path);
+        if(subscriptions_.end() == iter)
+            return;
+        for(const auto& subscription : iter->second)
+            calls.emplace_back(&change, subscription.second);
+    }
+    void reclaim()
+    {//...destroys retired versions which are not referred by any hazard
+        std::vector<const config_version*> hazards;
+        for(const hazard* iter = hazards_.load(); iter; iter = iter->next)
+        {
+            if(const config_version* const pointer = iter->pointer.load())
+                hazards.push_back(pointer);
+        }
+        std::sort(hazards.begin(), hazards.end());
+        const auto end = std::remove_if(retired_.begin(), retired_.end(),
+            [&hazards](const config_version* retired)
+            {
+                if(std::binary_search(hazards.begin(), hazards.end(), retired))
+                    return false;
+                delete retired;
+                return true;
+            });
+        retired_.erase(end, retired_.end());
+    }
+    //...
+    const std::string app_name_, instance_name_;
+    const source_loader loader_;
+    std::atomic<const config_version*> current_;
+    std::atomic<std::uint64_t> version_;
+    mutable std::atomic<hazard*> hazards_;
+    std::mutex reload_mutex_;
+    std::vector<const config_version*> retired_;//...guarded by reload_mutex_
+    mutable std::mutex subscriptions_mutex_;
+    std::map<std::string, std::map<subscription_id, change_callback>> subscriptions_;
+    subscription_id last_subscription_id_{};
+};
+
+reloadable_config::snapshot::snapshot(const reloadable_config& owner):
+    hazard_{&owner.impl_->acquire_hazard()}
+{
+    const config_version& current(owner.impl_->protect(*hazard_));
+    config_ = &current.cfg;
+    version_ = current.number;
+}
+
+reloadable_config::snapshot::~snapshot()
+{
+    hazard_->pointer.store(nullptr, std::memory_order_release);
+    hazard_->busy.store(false, std::memory_order_release);
+}
+
+reloadable_config::reloadable_config(
+    const std::string& app_name,
+    const std::string& instance_name,
+    const source_loader& loader):
+    impl_{new impl{app_name, instance_name, loader}}
+{}
+
+reloadable_config::~reloadable_config() {}
+
+void reloadable_config::reload()
+{
+    impl_->reload();
+}
+
+std::uint64_t reloadable_config::version() const
+{
+    return impl_->version();
+}
+
+reloadable_config::subscription_id reloadable_config::subscribe(
+    const std::string& path,
+    const change_callback& callback)
+{
+    return impl_->subscribe(path, callback);
+}
+
+void reloadable_config::unsubscribe(subscription_id id)
+{
+    impl_->unsubscribe(id);
+}
+
+}//namespace jet
@@ -0,0 +1,77 @@
+// jet.config library
+//
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef JET_CONFIG_RELOADABLE_CONFIG_HEADER_GUARD
+#define JET_CONFIG_RELOADABLE_CONFIG_HEADER_GUARD
+
+#include "config.hpp"
+#include <boost/noncopyable.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace jet
+{
+
+//...locked config which can be rebuilt from its sources while other threads read it.
+//...reload() merges and locks new config aside and publishes it with one atomic pointer swap,
+//...so readers never wait and always see the whole old or the whole new config.
+//...Config replaced by reload() is destroyed by one of the next reloads, after all snapshots which
+//...refer to it are released
+class reloadable_config: boost::noncopyable
+{
+    class impl;
+    struct hazard;
+public:
+    //...returns sources in the order they have to be merged, it's called on every reload
+    using source_loader = std::function<std::vector<config_source>()>;
+    using change_callback = std::function<void(const config_change&)>;
+    using subscription_id = std::uint64_t;
+
+    //...pins config which is current at the moment of construction. Snapshot is cheap to create
+    //...(no locks, no reference counting), but it's supposed to be short-lived and used by one thread
+    class snapshot: boost::noncopyable
+    {
+    public:
+        explicit snapshot(const reloadable_config& owner);
+        ~snapshot();
+        const config& operator*() const { return *config_; }
+        const config* operator->() const { return config_; }
+        std::uint64_t version() const { return version_; }//...1 for initial config, +1 on every reload
+    private:
+        hazard* hazard_;
+        const config* config_;
+        std::uint64_t version_;
+    };
+
+    //...loads initial config, throws if it can't be built
+    reloadable_config(
+        const std::string& app_name,
+        const std::string& instance_name,
+        const source_loader& loader);
+    ~reloadable_config();//...there must be no snapshots at this moment
+
+    //...if new config can't be built, current config stays and exception is thrown
+    void reload();
+    std::uint64_t version() const;
+
+    //...'path' is property path ('server.threads'), 'node.*' for all properties under the node or
+    //...'*' for all properties. Callbacks are called by reload() for every changed property after
+    //...new config is published, config changes are found by diff() of old and new config
+    //...(which relies on hashes of subtrees, see diff()).
+    //...Exception thrown by callback is propagated by reload(), new config stays published
+    subscription_id subscribe(const std::string& path, const change_callback& callback);
+    void unsubscribe(subscription_id id);
+private:
+    std::unique_ptr<impl> impl_;
+};
+
+}//namespace jet
+
+#endif /*JET_CONFIG_RELOADABLE_CONFIG_HEADER_GUARD*/
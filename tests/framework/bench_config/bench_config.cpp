@@ -0,0 +1,546 @@
+//  Copyright Alexey Tkachenko 2014. Use, modification and
+//  distribution is subject to the Boost Software License, Version
+//  1.0. (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include "config/config.hpp"
+#include "config/reloadable_config.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using jet::config_source;
+using jet::config;
+
+//...allocations are counted per thread (so counting doesn't make threads contend),
+//...lookup benchmarks report allocations per iteration
+namespace
+{
+thread_local std::size_t allocations{0};
+}//anonymous namespace
+
+//...allocations are counted by replaced global operators, memory itself comes from malloc. GCC
+//...inlines them into new/delete expressions and takes free() of operator new result for mismatch
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if(void* const result = std::malloc(size ? size : 1))
+        return result;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace
+{
+
+//...sizes of generated configs: number of sections with 10 properties each
+const int small_config{10}, medium_config{1000}, huge_config{20000};
+const size_t properties_per_section{10};
+
+//...the same config in both formats: 'sections' nodes with 'properties' attributes each,
+//...value of property is its number
+std::string make_xml_config(size_t sections, size_t properties)
+{
+    std::ostringstream strm;
+    strm << "<config><app>";
+    for(size_t section = 0; section < sections; ++section)
+    {
+        strm << "<section" << section;
+        for(size_t property = 0; property < properties; ++property)
+            strm << " property" << property << "='" << section * properties + property << '\'';
+        strm << "/>";
+    }
+    strm << "</app></config>";
+    return strm.str();
+}
+
+std::string make_json_config(size_t sections, size_t properties)
+{
+    std::ostringstream strm;
+    strm << "{\"config\":{\"app\":{";
+    for(size_t section = 0; section < sections; ++section)
+    {
+        strm << (section ? "," : "") << "\"section" << section << "\":{";
+        for(size_t property = 0; property < properties; ++property)
+            strm << (property ? "," : "") << "\"property" << property << "\":\""
+                << section * properties + property << '"';
+        strm << '}';
+    }
+    strm << "}}}";
+    return strm.str();
+}
+
+std::string make_config(size_t sections, config_source::input_format format)
+{
+    return config_source::xml == format ?
+        make_xml_config(sections, properties_per_section) :
+        make_json_config(sections, properties_per_section);
+}
+
+//...parse throughput
+
+void parse_string(benchmark::State& state, config_source::input_format format)
+{
+    const std::string text{make_config(state.range(0), format)};
+    for(auto _ : state)
+    {
+        const config_source source{config_source::from_string{text}.input_format(format)};
+        benchmark::DoNotOptimize(&source);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void parse_xml(benchmark::State& state)
+{
+    parse_string(state, config_source::xml);
+}
+
+void parse_json(benchmark::State& state)
+{
+    parse_string(state, config_source::json);
+}
+
+//...file is written once per benchmark, so it's mostly read from OS cache
+template<typename factory_type>
+void parse_file(benchmark::State& state, config_source::input_format format)
+{
+    const std::string text{make_config(state.range(0), format)};
+    const std::string filename{"bench_config_source.tmp"};
+    std::ofstream{filename, std::ios::out | std::ios::binary | std::ios::trunc} << text;
+    for(auto _ : state)
+    {
+        const config_source source{factory_type{filename}.input_format(format)};
+        benchmark::DoNotOptimize(&source);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    std::remove(filename.c_str());
+}
+
+void parse_xml_file(benchmark::State& state)
+{
+    parse_file<config_source::from_file>(state, config_source::xml);
+}
+
+void parse_json_file(benchmark::State& state)
+{
+    parse_file<config_source::from_file>(state, config_source::json);
+}
+
+void parse_xml_mapped_file(benchmark::State& state)
+{
+    parse_file<config_source::from_mapped_file>(state, config_source::xml);
+}
+
+//...copy of source: sources are passed by value to helpers and merged into many configs
+
+void copy_source(benchmark::State& state)
+{
+    const config_source source{config_source::from_string{make_xml_config(state.range(0), properties_per_section)}};
+    for(auto _ : state)
+    {
+        const config_source copy{source};
+        benchmark::DoNotOptimize(&copy);
+    }
+}
+
+//...merge
+
+//...'sources' layers of config, every layer overrides every other property of previous one.
+//...Wide config is one node with 'size' properties, deep config is 'size' nested nodes
+std::vector<config_source> make_layers(size_t sources, size_t size, bool wide)
+{
+    std::vector<config_source> layers;
+    for(size_t source = 0; source < sources; ++source)
+    {
+        std::ostringstream strm;
+        strm << "<config><app>";
+        for(size_t node = 0; node < size; ++node)
+        {
+            if(wide)
+                strm << "<property" << node << '>' << source << "</property" << node << '>';
+            else
+                strm << "<node" << node << " property" << source % 2 << "='" << source << "'>";
+        }
+        if(!wide)
+            for(size_t node = size; node > 0; --node)
+                strm << "</node" << node - 1 << '>';
+        strm << "</app></config>";
+        layers.emplace_back(config_source::from_string{strm.str()}.name("layer" + std::to_string(source)));
+    }
+    return layers;
+}
+
+void merge(benchmark::State& state, size_t sources, size_t size, bool wide)
+{
+    const std::vector<config_source> layers{make_layers(sources, size, wide)};
+    for(auto _ : state)
+    {
+        config cfg{"app"};
+        for(const config_source& layer : layers)
+            cfg << layer;
+        benchmark::DoNotOptimize(&cfg);
+    }
+}
+
+void merge_wide(benchmark::State& state)
+{
+    merge(state, 6, state.range(0), true);
+}
+
+void merge_deep(benchmark::State& state)
+{
+    merge(state, 6, state.range(0), false);
+}
+
+void merge_sources(benchmark::State& state)
+{//...cost of every extra source: 1000 properties each
+    merge(state, state.range(0), 1000, true);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//...lock
+
+void lock(benchmark::State& state)
+{//...merge is excluded from the measurement, only lock (building of the snapshot) is measured
+    const config_source source{config_source::from_string{make_xml_config(state.range(0), properties_per_section)}};
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        std::unique_ptr<config> cfg{new config{"app"}};
+        *cfg << source;
+        state.ResumeTiming();
+        *cfg << jet::lock;
+        benchmark::DoNotOptimize(cfg.get());
+        state.PauseTiming();
+        cfg.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * (properties_per_section + 1));
+}
+
+//...config of instance: 'huge_config' sections, instance overrides one property.
+//...Regular config merges and locks everything per instance, factory builds only the overlay
+
+std::vector<config_source> instance_sources()
+{
+    const std::string text{make_xml_config(huge_config, properties_per_section)};
+    return {
+        config_source{config_source::from_string{text}},
+        config_source{config_source::from_string{
+            "<config><app><instance><i1><section500 property5='0'/></i1></instance></app></config>"}}};
+}
+
+void instance_config(benchmark::State& state)
+{
+    const std::vector<config_source> sources{instance_sources()};
+    for(auto _ : state)
+    {
+        config cfg{"app", "i1"};
+        cfg << sources << jet::lock;
+        benchmark::DoNotOptimize(&cfg);
+    }
+}
+
+void factory_instance_config(benchmark::State& state)
+{
+    const jet::config_factory factory{"app", instance_sources()};
+    std::size_t memory{};
+    for(auto _ : state)
+    {
+        const config cfg{factory.create("i1")};
+        memory = cfg.memory_usage();
+        benchmark::DoNotOptimize(&cfg);
+    }
+    state.counters["bytes"] = static_cast<double>(memory);
+}
+
+//...conversion of property text: lexical_cast (used before) against the locale-free parsers.
+//...Values are converted in the loop over the same set of texts
+
+const std::vector<std::string>& conversion_texts(bool floating)
+{
+    static const std::vector<std::string> integers{"0", "42", "-7", "65535", "1000000", "-2147483648", "9000000000"};
+    static const std::vector<std::string> reals{"0.5", "-1.25", "3.14159", "2.5e-3", "100", "1e10", "0.1"};
+    return floating ? reals : integers;
+}
+
+template<typename T>
+void convert_lexical_cast(benchmark::State& state)
+{
+    const std::vector<std::string>& texts(conversion_texts(std::is_floating_point<T>::value));
+    T result{};
+    for(auto _ : state)
+        for(const std::string& text : texts)
+            benchmark::DoNotOptimize(boost::conversion::try_lexical_convert(text.data(), text.size(), result));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * texts.size()));
+}
+
+template<typename T>
+void convert_parser(benchmark::State& state)
+{
+    const std::vector<std::string>& texts(conversion_texts(std::is_floating_point<T>::value));
+    T result{};
+    for(auto _ : state)
+        for(const std::string& text : texts)
+            benchmark::DoNotOptimize(jet::detail::config_value_parser<T>::parse(text, result));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * texts.size()));
+}
+
+void get_duration(benchmark::State& state)
+{
+    static const config cfg{[]
+        {
+            config result{"app"};
+            result << config_source{config_source::from_string{"<app timeout='250ms' size='64KiB'/>"}} << jet::lock;
+            return result;
+        }()};
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(cfg.get<std::chrono::milliseconds>("timeout"));
+        benchmark::DoNotOptimize(cfg.get<jet::byte_size>("size"));
+    }
+}
+
+//...numeric table of 'state.range(0)' repeated values: conversion of every node vs array converted by lock
+
+const config& table_config(std::size_t size)
+{
+    static std::map<std::size_t, config> configs;
+    auto iter = configs.find(size);
+    if(configs.end() == iter)
+    {
+        std::ostringstream strm;
+        strm << "<app><table>";
+        for(std::size_t index = 0; index < size; ++index)
+            strm << "<w>" << index * 0.25 << "</w>";
+        strm << "</table></app>";
+        config result{"app"};
+        result << config_source{config_source::from_string{strm.str()}} << jet::lock;
+        iter = configs.insert({size, result}).first;
+    }
+    return iter->second;
+}
+
+void sum_children(benchmark::State& state)
+{
+    const config& cfg(table_config(static_cast<std::size_t>(state.range(0))));
+    for(auto _ : state)
+    {
+        double sum{};
+        for(const jet::config_node& child : cfg.children_of("table"))
+            sum += child.get<double>();
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+void sum_array(benchmark::State& state)
+{
+    const config& cfg(table_config(static_cast<std::size_t>(state.range(0))));
+    for(auto _ : state)
+    {
+        double sum{};
+        for(const double value : cfg.get_array<double>("table.w"))
+            sum += value;
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+//...lookup latency: config with 'medium_config' sections is locked once and shared by benchmarks
+
+const config& lookup_config()
+{
+    static const config cfg{[]
+        {
+            config result{"app"};
+            result << config_source{config_source::from_string{
+                make_xml_config(medium_config, properties_per_section)}} << jet::lock;
+            return result;
+        }()};
+    return cfg;
+}
+
+//...runs 'lookup' in the loop and reports allocations per lookup
+template<typename lookup_type>
+void measure_lookup(benchmark::State& state, lookup_type lookup)
+{
+    const config& cfg(lookup_config());
+    const std::size_t initial_allocations{allocations};
+    for(auto _ : state)
+        lookup(cfg);
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(allocations - initial_allocations),
+        benchmark::Counter::kAvgIterations);
+}
+
+void get_int(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            benchmark::DoNotOptimize(cfg.get<int>("section500.property5"));
+        });
+}
+
+void get_string(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            benchmark::DoNotOptimize(cfg.get("section500.property5"));
+        });
+}
+
+void get_view(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            benchmark::DoNotOptimize(cfg.get_view("section500.property5"));
+        });
+}
+
+void get_optional_missing(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            benchmark::DoNotOptimize(cfg.get_optional<int>("section500.missing"));
+        });
+}
+
+void get_key(benchmark::State& state)
+{
+    const jet::config_key<int> key{lookup_config().key<int>("section500.property5")};
+    measure_lookup(state, [&key](const config&)
+        {
+            benchmark::DoNotOptimize(key.get());
+        });
+}
+
+void get_node(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            const jet::config_node node{cfg.get_node("section500")};
+            benchmark::DoNotOptimize(&node);
+        });
+}
+
+void get_children_of(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            const std::vector<jet::config_node> children{cfg.get_children_of("section500")};
+            benchmark::DoNotOptimize(children.data());
+        });
+}
+
+void children_of(benchmark::State& state)
+{
+    measure_lookup(state, [](const config& cfg)
+        {
+            for(const jet::config_node& child : cfg.children_of("section500"))
+                benchmark::DoNotOptimize(&child);
+        });
+}
+
+void view_get_int(benchmark::State& state)
+{
+    const jet::config_view view{lookup_config().view()};
+    measure_lookup(state, [&view](const config&)
+        {
+            benchmark::DoNotOptimize(view.get<int>("section500.property5"));
+        });
+}
+
+//...concurrent readers: the same lookups from several threads, time per thread has to stay flat
+
+void concurrent_get(benchmark::State& state)
+{
+    const config& cfg(lookup_config());
+    int section{state.thread_index() * 97 % medium_config};
+    for(auto _ : state)
+    {
+        const jet::config_node node{cfg.get_node("section" + std::to_string(section))};
+        benchmark::DoNotOptimize(node.get<int>("property5"));
+        benchmark::DoNotOptimize(node.get_children_of().size());
+        section = (section + 1) % medium_config;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void concurrent_view_get(benchmark::State& state)
+{
+    const jet::config_view view{lookup_config().view()};
+    for(auto _ : state)
+        benchmark::DoNotOptimize(view.get<int>("section500.property5"));
+    state.SetItemsProcessed(state.iterations());
+}
+
+void concurrent_snapshot_get(benchmark::State& state)
+{//...every read pins the current version of reloadable config
+    static jet::reloadable_config reloadable{"app", "", []
+        {
+            return std::vector<config_source>{config_source{config_source::from_string{
+                make_xml_config(medium_config, properties_per_section)}}};
+        }};
+    for(auto _ : state)
+    {
+        const jet::reloadable_config::snapshot snapshot{reloadable};
+        benchmark::DoNotOptimize(snapshot->get_view("section500.property5"));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}//anonymous namespace
+
+BENCHMARK(parse_xml)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(parse_json)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(parse_xml_file)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(parse_json_file)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(parse_xml_mapped_file)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(copy_source)->Arg(small_config)->Arg(huge_config);
+BENCHMARK(merge_wide)->Arg(10)->Arg(1000)->Arg(10000);
+BENCHMARK(merge_deep)->Arg(10)->Arg(100);
+BENCHMARK(merge_sources)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(lock)->Arg(small_config)->Arg(medium_config)->Arg(huge_config);
+BENCHMARK(instance_config);
+BENCHMARK(factory_instance_config);
+BENCHMARK_TEMPLATE(convert_lexical_cast, long long);
+BENCHMARK_TEMPLATE(convert_parser, long long);
+BENCHMARK_TEMPLATE(convert_lexical_cast, double);
+BENCHMARK_TEMPLATE(convert_parser, double);
+BENCHMARK(get_duration);
+BENCHMARK(sum_children)->Arg(100)->Arg(10000);
+BENCHMARK(sum_array)->Arg(100)->Arg(10000);
+BENCHMARK(get_int);
+BENCHMARK(get_string);
+BENCHMARK(get_view);
+BENCHMARK(get_optional_missing);
+BENCHMARK(get_key);
+BENCHMARK(get_node);
+BENCHMARK(get_children_of);
+BENCHMARK(children_of);
+BENCHMARK(view_get_int);
+BENCHMARK(concurrent_get)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(concurrent_view_get)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(concurrent_snapshot_get)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -6,7 +6,16 @@
 #include "gtest.hpp"
 #include "config/config.hpp"
 #include "config/config_error.hpp"
+#include "config/config_schema.hpp"
+#include "config/reloadable_config.hpp"
+#include <boost/lexical_cast.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <new>
+#include <thread>
 
 #define EXPECT_CONFIG_ERROR(EXPRESSION, MATCHER) \
     EXPECT_ERROR_EX(EXPRESSION, ::jet::config_error, MATCHER)
@@ -19,6 +28,55 @@ using jet::test::start_with;
 using jet::config_source;
 using jet::config;
 
+namespace
+{
+std::atomic<size_t> allocation_count{0};//...number of calls to global operator new
+}//anonymous namespace
+
+//...allocations are counted by replaced global operators, memory itself comes from malloc. GCC
+//...inlines them into new/delete expressions and takes free() of operator new result for mismatch
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
 TEST(config_source, simple_config_source)
 {
     const config_source source{config_source::from_string{"<app> <attr> value</attr></app> "}};
@@ -52,6 +110,30 @@ TEST(config_source, invalid_config_source)
             ("<unspecified file>(1): expected <"));
 }
 
+TEST(config_source, xml_syntax_config_source)
+{
+    EXPECT_EQ(
+        config_source::from_string{
+            "\xEF\xBB\xBF<?xml version='1.0'?>\n"
+            "<!DOCTYPE app [<!ELEMENT app ANY>]>\n"
+            "<app attr='a &amp; &#x42;&#67;'>\n"
+            "    <!-- comment -->\n"
+            "    <text>  one\n\t two  </text>\n"
+            "    <raw><![CDATA[<raw>]]></raw>\n"
+            "</app>"}.create().to_string(config_source::one_line),
+        "<config><app><attr>a &amp; BC</attr><text>one two</text><raw>&lt;raw&gt;</raw></app></config>");
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"<app>\n<a x='1'/>\n</app"}.create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("<unspecified file>(3): expected >"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"<app>\n<a x=1/>\n</app>"}.create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("<unspecified file>(2): expected ' or \""));
+}
+
 TEST(config_source, simple_config_source_pretty_print)
 {
     const config_source source{config_source::from_string{" <app><attr>value  </attr></app>"}};
@@ -76,6 +158,140 @@ TEST(config_source, attr_config_source)
         source.to_string());
 }
 
+TEST(config_source, json_config_source)
+{
+    const config_source source{config_source::from_string{
+        "{ \"app..i1\": { \"attr\": \"value\", \"port\": 8080, \"ratio\": -1.5e3, \"on\": true, \"none\": null,\n"
+        "  \"box\": [ {\"host\": \"h1\"}, {\"host\": \"h2\"} ], \"tag\": [\"a\\\"b\", \"\\u00e9\\ud83d\\ude00\"], \"empty\": [] } }"}
+        .input_format(config_source::json)};
+    EXPECT_EQ(
+        "<config>\n"
+        "  <app>\n"
+        "    <instance>\n"
+        "      <i1>\n"
+        "        <attr>value</attr>\n"
+        "        <port>8080</port>\n"
+        "        <ratio>-1.5e3</ratio>\n"
+        "        <on>true</on>\n"
+        "        <none/>\n"
+        "        <box>\n"
+        "          <host>h1</host>\n"
+        "        </box>\n"
+        "        <box>\n"
+        "          <host>h2</host>\n"
+        "        </box>\n"
+        "        <tag>a&quot;b</tag>\n"
+        "        <tag>\xC3\xA9\xF0\x9F\x98\x80</tag>\n"
+        "      </i1>\n"
+        "    </instance>\n"
+        "  </app>\n"
+        "</config>\n",
+        source.to_string());
+
+    const config_source xml_source{config_source::from_string{
+        "<config><app><attr>value</attr><box host='h1'/><box host='h2'/></app></config>"}};
+    const config_source json_source{config_source::from_string{
+        "{\"config\":{\"app\":{\"attr\":\"value\",\"box\":[{\"host\":\"h1\"},{\"host\":\"h2\"}]}}}"}
+        .input_format(config_source::json)};
+    EXPECT_EQ(xml_source.to_string(), json_source.to_string());
+}
+
+TEST(config_source, invalid_json_config_source)
+{
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"{\n  \"app\": {\"attr\" \"value\"}}"}
+            .name("config.json").input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'config.json'")
+            ("Invalid JSON at line 2, column 18: expected ':'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"[]"}.input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("Invalid JSON at line 1, column 1: expected '{'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"{\"app\": {\"attr\": [[1]]}}"}.input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("Invalid JSON at line 1, column 19: arrays of arrays are not supported"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"{\"app\": {\"attr\": 01}}"}.input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("Invalid JSON at line 1, column 19: expected '}'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{"{}"}.input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'unknown'")
+            ("config source 'unknown' is empty"));
+}
+
+TEST(config_source, buffer_config_source)
+{
+    const char xml[]{"<app attr='value'/>, tail which is not parsed"};
+    const config_source xml_source{config_source::from_buffer{xml, 19}.name("xml")};
+    EXPECT_EQ("xml", xml_source.name());
+    EXPECT_EQ("<config><app><attr>value</attr></app></config>", xml_source.to_string(config_source::one_line));
+
+    const std::string json{"{\"app\": {\"attr\": \"value\"}}"};
+    const config_source json_source{
+        config_source::from_buffer{json.data(), json.size()}.input_format(config_source::json)};
+    EXPECT_EQ(xml_source.to_string(), json_source.to_string());
+
+    const std::string filename{"test_config_source.xml"};
+    std::ofstream{filename} << "<app attr='value'/>";
+    const config_source file_source{config_source::from_mapped_file{filename}};
+    EXPECT_EQ(filename, file_source.name());
+    EXPECT_EQ(xml_source.to_string(), file_source.to_string());
+    std::ofstream{filename};
+    EXPECT_CONFIG_ERROR(
+        config_source::from_mapped_file{filename}.create(),
+        equal
+            ("Couldn't parse config 'test_config_source.xml'")
+            ("Config source 'test_config_source.xml' is empty"));
+    std::remove(filename.c_str());
+    EXPECT_CONFIG_ERROR(
+        config_source::from_mapped_file{filename}.create(),
+        start_with("Couldn't parse config 'test_config_source.xml'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_file{filename}.create(),
+        equal
+            ("Couldn't parse config 'test_config_source.xml'")
+            ("Couldn't open file 'test_config_source.xml'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_file{filename}.input_format(config_source::json).create(),
+        equal
+            ("Couldn't parse config 'test_config_source.xml'")
+            ("Couldn't open file 'test_config_source.xml'"));
+}
+
+TEST(config_source, shared_config_source)
+{//...copies share parsed tree, so they don't allocate
+    const config_source source{config_source::from_string{
+        "<app threads='2'><instance><i1 threads='4'/><i2 threads='8'/></instance></app>"}.name("shared")};
+    std::vector<config_source> copies;
+    copies.reserve(100);
+    const size_t before{allocation_count};
+    for(int i = 0; i < 100; ++i)
+        copies.push_back(source);
+    config_source assigned{copies.front()};
+    assigned = copies.back();
+    const size_t after{allocation_count};
+    EXPECT_EQ(0U, after - before);
+    EXPECT_EQ("shared", assigned.name());
+    EXPECT_EQ(source.to_string(), assigned.to_string());
+
+    //...the same source is merged into config of every instance
+    config i1{"app", "i1"}, i2{"app", "i2"}, app{"app"};
+    i1 << assigned << jet::lock;
+    i2 << assigned << jet::lock;
+    app << assigned << jet::lock;
+    EXPECT_EQ(4, i1.get<int>("threads"));
+    EXPECT_EQ(8, i2.get<int>("threads"));
+    EXPECT_EQ(2, app.get<int>("threads"));
+    EXPECT_EQ(source.to_string(), copies[50].to_string());
+}
+
 TEST(config_source, normalize_instance_shortcut_config_source)
 {
     const config_source source{config_source::from_string{"<config><app..i1 attr='value'/></config>"}};
@@ -302,6 +518,28 @@ TEST(config_source, inconsistent_attribute_definition_config_source)
             ("Invalid element 'config.app.env' in config source 'InconsistentAttributeDefinitionConfigSource' contains both value and child attributes"));
 }
 
+TEST(config_source, validation_error_order)
+{//...when source has several errors the first failed check is reported, not the first invalid node
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{
+            "<config>"
+            "   <app><env attr='value1'>data</env></app>"
+            "   <app>data</app>"
+            "</config>"}.name("s1").create(),
+        start_with
+            ()
+            ("Invalid data node 'data' under 'app' node in config source 's1'"));
+    EXPECT_CONFIG_ERROR(
+        config_source::from_string{
+            "<config>"
+            "   <app1/><app2/><app1/>"
+            "   <default><env/><env/></default>"
+            "</config>"}.name("s1").create(),
+        start_with
+            ()
+            ("Duplicate default node 'env' in config source 's1'"));
+}
+
 TEST(config_source, duplicate_attr_config_source)
 {//TODO: submit bugreport to boost comunity - two attributes with the same name is not well formed xml
     EXPECT_CONFIG_ERROR(
@@ -445,6 +683,11 @@ TEST(config_source, normalize_keywords)
             .file_name_style(config_source::case_insensitive)
             .create().to_string(config_source::one_line),
         "<config><app/></config>");
+    EXPECT_EQ(
+        config_source::from_string{"<Long_Application-Name.0@Z/><app/>"}
+            .file_name_style(config_source::case_insensitive)
+            .create().to_string(config_source::one_line),
+        "<config><long_application-name.0@z/><app/></config>");
 }
 
 TEST(config_source, prohibited_simple_default_attributes)
@@ -576,8 +819,7 @@ TEST(config, getters)
     EXPECT_CONFIG_ERROR(
         config.get<int>("str"),
         start_with
-            ("Can't convert value 'value' of a property 'str' in config 'app..1'")
-            ("bad lexical cast"));
+            ("Can't convert value 'value' of a property 'str' in config 'app..1'"));
     
     //...optional getter
     EXPECT_EQ("value", *config.get_optional("str"));
@@ -587,8 +829,7 @@ TEST(config, getters)
     EXPECT_CONFIG_ERROR(
         config.get_optional<int>("str"),
         start_with
-            ("Can't convert value 'value' of a property 'str' in config 'app..1'")
-            ("bad lexical cast"));
+            ("Can't convert value 'value' of a property 'str' in config 'app..1'"));
     
     //...default getter
     EXPECT_EQ("value", config.get("str", "anotherValue"));
@@ -597,11 +838,218 @@ TEST(config, getters)
     EXPECT_CONFIG_ERROR(
         config.get("str", 12),
         start_with
-            ("Can't convert value 'value' of a property 'str' in config 'app..1'")
-            ("bad lexical cast"));
+            ("Can't convert value 'value' of a property 'str' in config 'app..1'"));
     
 }
 
+TEST(config, typed_getters)
+{
+    const config_source s1{config_source::from_string{
+        "<app neg='-7' big='70000' huge='5000000000' real='2.5' flag='1' text='12a' empty=''/>"}.name("s1.xml")};
+
+    config config{"app"};
+    config << s1 << jet::lock;
+
+    EXPECT_EQ(-7, config.get<int>("neg"));
+    EXPECT_EQ(-7, config.get<long long>("neg"));
+    EXPECT_EQ(-7., config.get<double>("neg"));
+    EXPECT_EQ(70000, config.get<int>("big"));
+    EXPECT_EQ(5000000000LL, config.get<long long>("huge"));
+    EXPECT_EQ(2.5, config.get<double>("real"));
+    EXPECT_EQ(2.5f, config.get<float>("real"));
+    EXPECT_TRUE(config.get<bool>("flag"));
+    EXPECT_EQ(1U, config.get<unsigned>("flag"));
+    EXPECT_EQ('1', config.get<char>("flag"));
+    EXPECT_EQ("12a", config.get<std::string>("text"));
+    EXPECT_EQ(1, *config.get_optional<short>(" flag "));
+    EXPECT_EQ(boost::none, config.get_optional<int>("unknown"));
+    EXPECT_EQ(5, config.get("unknown", 5));
+
+    //...values which don't fit target type are reported exactly as before
+    EXPECT_CONFIG_ERROR(
+        config.get<short>("big"),
+        start_with
+            ("Can't convert value '70000' of a property 'big' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.get<int>("huge"),
+        start_with
+            ("Can't convert value '5000000000' of a property 'huge' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.get<bool>("neg"),
+        start_with
+            ("Can't convert value '-7' of a property 'neg' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.get_optional<int>("real"),
+        start_with
+            ("Can't convert value '2.5' of a property 'real' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.get<int>("empty"),
+        start_with
+            ("Can't convert value '' of a property 'empty' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.get<unsigned>("neg"),
+        start_with
+            ("Can't convert value '-7' of a property 'neg' in config 'app'"));
+}
+
+TEST(config, value_conversion)
+{
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <numbers int='+42' max='9223372036854775807' min='-9223372036854775808' over='9223372036854775808'\n\
+        real='0.1' exp='-1.5e-3' dot='.5' long='3.14159265358979323846' inf='inf' word='12e'\n\
+        fmax='3.4028235e38' fover='3.4028236e38' flow='-3.40282356e38'/>\n\
+    <flags t1='true' t2='Yes' t3='ON' f1='false' f2='no' f3='Off' bad='y'/>\n\
+    <durations plain='250' ms='250ms' s='5s' frac='1.5s' min='2min' m='3m' h='1h' d='1d' us='1500us' bad='5 sec'/>\n\
+    <sizes plain='100' kib='64KiB' k='64k' g='2G' kb='64KB' frac='1.5MB' half='0.5KiB' tb='1TB' bad='1.5B'/>\n\
+</app>\n"}.name("s1")};
+    config config{"app"};
+    config << s1 << jet::lock;
+    const jet::config_node numbers{config.get_node("numbers")};
+    EXPECT_EQ(42, numbers.get<int>("int"));
+    EXPECT_EQ(std::numeric_limits<long long>::max(), numbers.get<long long>("max"));
+    EXPECT_EQ(std::numeric_limits<long long>::min(), numbers.get<long long>("min"));
+    EXPECT_EQ(9223372036854775808ULL, numbers.get<unsigned long long>("over"));
+    EXPECT_EQ(0.1, numbers.get<double>("real"));
+    EXPECT_EQ(-1.5e-3, numbers.get<double>("exp"));
+    EXPECT_EQ(0.5f, numbers.get<float>("dot"));
+    EXPECT_EQ(3.14159265358979323846, numbers.get<double>("long"));
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), numbers.get<double>("inf"));
+    EXPECT_EQ(std::numeric_limits<float>::max(), numbers.get<float>("fmax"));//...rounded to max
+    EXPECT_EQ(std::numeric_limits<float>::lowest(), numbers.get<float>("flow"));
+    EXPECT_CONFIG_ERROR(
+        numbers.get<float>("fover"),
+        equal("Can't convert value '3.4028236e38' of a property 'fover' in config 'app.numbers'"));
+    for(const float limit : {std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()})
+    {
+        const std::string text{boost::lexical_cast<std::string>(limit)};
+        jet::config limits{"app"};
+        limits << config_source{config_source::from_string{"<app value='" + text + "'/>"}} << jet::lock;
+        EXPECT_EQ(limit, limits.get<float>("value")) << text;
+    }
+    EXPECT_CONFIG_ERROR(
+        numbers.get<long long>("over"),
+        equal("Can't convert value '9223372036854775808' of a property 'over' in config 'app.numbers'"));
+    EXPECT_CONFIG_ERROR(
+        numbers.get<double>("word"),
+        equal("Can't convert value '12e' of a property 'word' in config 'app.numbers'"));
+
+    const jet::config_node flags{config.get_node("flags")};
+    EXPECT_TRUE(flags.get<bool>("t1") && flags.get<bool>("t2") && flags.get<bool>("t3"));
+    EXPECT_FALSE(flags.get<bool>("f1") || flags.get<bool>("f2") || flags.get<bool>("f3"));
+    EXPECT_TRUE(config.key<bool>("flags.t2").get());
+    EXPECT_CONFIG_ERROR(
+        flags.get<bool>("bad"),
+        equal("Can't convert value 'y' of a property 'bad' in config 'app.flags'"));
+
+    using std::chrono::milliseconds;
+    using std::chrono::seconds;
+    const jet::config_node durations{config.get_node("durations")};
+    EXPECT_EQ(milliseconds{250}, durations.get<milliseconds>("plain"));
+    EXPECT_EQ(milliseconds{250}, durations.get<milliseconds>("ms"));
+    EXPECT_EQ(milliseconds{5000}, durations.get<milliseconds>("s"));
+    EXPECT_EQ(milliseconds{1500}, durations.get<milliseconds>("frac"));
+    EXPECT_EQ(seconds{120}, durations.get<seconds>("min"));
+    EXPECT_EQ(seconds{180}, durations.get<seconds>("m"));
+    EXPECT_EQ(std::chrono::hours{24}, durations.get<std::chrono::hours>("d"));
+    EXPECT_EQ(std::chrono::microseconds{1500}, durations.get<std::chrono::microseconds>("us"));
+    EXPECT_EQ(seconds{3600}, durations.get("h", seconds{}));
+    EXPECT_CONFIG_ERROR(
+        durations.get<milliseconds>("us"),//...it isn't whole number of milliseconds
+        equal("Can't convert value '1500us' of a property 'us' in config 'app.durations'"));
+    EXPECT_CONFIG_ERROR(
+        durations.get<seconds>("bad"),
+        equal("Can't convert value '5 sec' of a property 'bad' in config 'app.durations'"));
+
+    using jet::byte_size;
+    const jet::config_node sizes{config.get_node("sizes")};
+    EXPECT_EQ(byte_size{100}, sizes.get<byte_size>("plain"));
+    EXPECT_EQ(byte_size{65536}, sizes.get<byte_size>("kib"));
+    EXPECT_EQ(byte_size{65536}, sizes.get<byte_size>("k"));
+    EXPECT_EQ(byte_size{2147483648ULL}, sizes.get<byte_size>("g"));
+    EXPECT_EQ(byte_size{64000}, sizes.get<byte_size>("kb"));
+    EXPECT_EQ(byte_size{1500000}, sizes.get<byte_size>("frac"));
+    EXPECT_EQ(byte_size{512}, sizes.get<byte_size>("half"));
+    EXPECT_EQ(byte_size{1000000000000ULL}, *sizes.get_optional<byte_size>("tb"));
+    EXPECT_CONFIG_ERROR(
+        sizes.get<byte_size>("bad"),
+        equal("Can't convert value '1.5B' of a property 'bad' in config 'app.sizes'"));
+}
+
+TEST(config, keys)
+{
+    const config_source s1{config_source::from_string{
+        "<app str='value' threads='8'><limits rate='0.5' enabled='1'/></app>"}.name("s1.xml")};
+
+    config config{"app"};
+    EXPECT_CONFIG_ERROR(
+        config.key<int>("threads"),
+        equal("Initialization of config 'app' is not finished"));
+    config << s1 << jet::lock;
+
+    const jet::config_key<int> threads{config.key<int>(" threads ")};
+    const jet::config_key<double> rate{config.get_node("limits").key<double>("rate")};
+    const jet::config_key<bool> enabled{config.key<bool>("limits.enabled")};
+    EXPECT_TRUE(std::is_trivially_copyable<jet::config_key<int>>::value);
+    EXPECT_EQ(8, threads.get());
+    EXPECT_EQ(0.5, rate.get());
+    EXPECT_TRUE(enabled.get());
+
+    jet::config_key<int> copy;
+    copy = threads;
+    EXPECT_EQ(8, copy.get());
+
+    EXPECT_CONFIG_ERROR(
+        config.key<int>("unknown"),
+        equal("Can't find property 'unknown' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        config.key<int>("limits"),
+        equal("Node 'app.limits' is intermidiate node without value"));
+    EXPECT_CONFIG_ERROR(
+        config.key<int>("str"),
+        start_with("Can't convert value 'value' of a property 'str' in config 'app'"));
+}
+
+TEST(config, allocation_free_getters)
+{
+    const config_source s1{config_source::from_string{
+        "<application_with_long_name>"
+        "  <section_with_long_name property_with_long_name='value_which_does_not_fit_into_small_string' number_with_long_name='42'/>"
+        "</application_with_long_name>"}.name("s1.xml")};
+
+    config config{"application_with_long_name"};
+    config << s1 << jet::lock;
+
+    const std::string property{" section_with_long_name.property_with_long_name "};
+    const std::string number{"section_with_long_name.number_with_long_name"};
+    const std::string section{"section_with_long_name"};
+    const std::string unknown{"section_with_long_name.unknown_property_with_long_name"};
+
+    size_t total_size{0}, total_number{0}, found{0};
+    const size_t before{allocation_count};
+    for(int i = 0; i < 10; ++i)
+    {
+        total_size += config.get_view(property).size();
+        total_size += config.get_view_optional(property)->size();
+        total_number += config.get<int>(number);
+        total_number += *config.get_optional<unsigned>(number);
+        total_number += config.get(unknown, 1);
+        total_number += config.key<long>(number).get();
+        const jet::config_node node{config.get_node(section)};
+        total_size += node.get_view("property_with_long_name").size();
+        found += config.get_node_optional(unknown) ? 0 : 1;
+        found += config.get_view_optional(unknown) ? 0 : 1;
+        found += config.get_optional<int>(unknown) ? 0 : 1;
+    }
+    const size_t after{allocation_count};
+
+    EXPECT_EQ(0U, after - before);
+    EXPECT_EQ(10 * 3 * std::string{"value_which_does_not_fit_into_small_string"}.size(), total_size);
+    EXPECT_EQ(10U * (42 * 3 + 1), total_number);
+    EXPECT_EQ(30U, found);
+    EXPECT_EQ("value_which_does_not_fit_into_small_string", config.get_view(property));
+}
+
 TEST(config, initialization)
 {
     const config_source s1{config_source::from_string{
@@ -738,6 +1186,169 @@ TEST(config, get_children_of)
     }
 }
 
+TEST(config, children_of)
+{
+    const config_source s1{config_source::from_string{
+"<routing>\n\
+    <routes>\n\
+        <route_with_long_name destination='destination_with_long_name_1' weight='1'/>\n\
+        <route_with_long_name destination='destination_with_long_name_2' weight='2'/>\n\
+        <route_with_long_name destination='destination_with_long_name_3' weight='3'/>\n\
+    </routes>\n\
+    <empty/>\n\
+</routing>\n"}.name("s1")};
+    config routing{"routing"};
+    routing << s1 << jet::lock;
+
+    const jet::config_children routes{routing.children_of(" routes ")};
+    ASSERT_EQ(3U, routes.size());
+    EXPECT_FALSE(routes.empty());
+    EXPECT_TRUE(routing.children_of("empty").empty());
+    EXPECT_EQ(routing.children_of("empty").begin(), routing.children_of("empty").end());
+
+    size_t total_size{0}, total_weight{0}, count{0};
+    const size_t before{allocation_count};
+    for(const jet::config_node& route : routes)
+    {
+        total_size += route.get_view("destination").size();
+        total_weight += route.get<unsigned>("weight");
+        ++count;
+    }
+    const size_t after{allocation_count};
+    EXPECT_EQ(0U, after - before);
+    EXPECT_EQ(3U, count);
+    EXPECT_EQ(3 * std::string{"destination_with_long_name_1"}.size(), total_size);
+    EXPECT_EQ(6U, total_weight);
+
+    jet::config_children::iterator iter{routes.begin()};
+    const jet::config_node first{*iter++};
+    EXPECT_EQ("destination_with_long_name_1", first.get("destination"));
+    EXPECT_EQ("routing.routes.route_with_long_name", iter->name());
+    EXPECT_EQ("route_with_long_name", iter->node_name());
+    EXPECT_EQ("destination_with_long_name_2", iter->get("destination"));
+    EXPECT_EQ(3, std::distance(routes.begin(), routes.end()));
+
+    EXPECT_CONFIG_ERROR(
+        routing.children_of("unknown"),
+        equal("config 'routing' doesn't have child 'unknown'"));
+}
+
+TEST(config, view)
+{
+    static_assert(sizeof(jet::config_view) == 2 * sizeof(void*), "config_view must be two pointers wide");
+    static_assert(std::is_trivially_copyable<jet::config_view>::value, "config_view must be trivially copyable");
+
+    const config_source s1{config_source::from_string{
+"<deployment>\n\
+    <regions>\n\
+        <UK threads='2'><box hostname='UK1'/><box hostname='UK2'/></UK>\n\
+        <US threads='3'><box hostname='US1'/></US>\n\
+    </regions>\n\
+</deployment>\n"}.name("s1")};
+    config deployment{"deployment", "i1"};
+    deployment << s1 << jet::lock;
+
+    const jet::config_view root{deployment};
+    const jet::config_view uk{root.get_node("regions.UK")};
+    EXPECT_EQ("deployment..i1.regions.UK", uk.name());
+    EXPECT_EQ("regions.UK", uk.path());
+    EXPECT_EQ("UK", uk.node_name());
+    EXPECT_EQ(2, uk.get<int>("threads"));
+    EXPECT_EQ("UK1", uk.get_view("box.hostname"));
+    EXPECT_EQ(boost::none, uk.get_node_optional("unknown"));
+    EXPECT_EQ(7, uk.get("unknown", 7));
+    EXPECT_EQ(2, uk.key<int>("threads").get());
+    EXPECT_EQ("deployment..i1.regions.UK", deployment.get_node("regions.UK").view().name());
+    EXPECT_CONFIG_ERROR(
+        uk.get("unknown"),
+        equal("Can't find property 'unknown' in config 'deployment..i1.regions.UK'"));
+    {
+        std::stringstream strm;
+        strm << root.get_node("regions.US");
+        EXPECT_EQ("<deployment..i1.regions.US>\n<threads>3</threads>\n<box>\n  <hostname>US1</hostname>\n</box>\n</deployment..i1.regions.US>\n", strm.str());
+    }
+
+    //...views are passed to worker threads by value
+    std::vector<jet::config_view> regions;
+    for(const jet::config_view& region : root.children_of("regions"))
+        regions.push_back(region);
+    ASSERT_EQ(2U, regions.size());
+    std::vector<std::string> hostnames(regions.size());
+    std::vector<int> threads(regions.size());
+    std::vector<std::thread> workers;
+    for(size_t i = 0; i < regions.size(); ++i)
+    {
+        workers.emplace_back([i, &hostnames, &threads](jet::config_view region)
+            {
+                threads[i] = region.get<int>("threads");
+                for(const jet::config_view& box : region.children_of())
+                    if("box" == box.node_name())
+                        hostnames[i] += box.get("hostname");
+            },
+            regions[i]);
+    }
+    for(std::thread& worker : workers)
+        worker.join();
+    EXPECT_EQ("UK1UK2", hostnames[0]);
+    EXPECT_EQ("US1", hostnames[1]);
+    EXPECT_EQ(2, threads[0]);
+    EXPECT_EQ(3, threads[1]);
+}
+
+TEST(config, image)
+{
+    const config_source s1{config_source::from_string{
+"<deployment>\n\
+    <threads>4</threads>\n\
+    <ratio>0.5</ratio>\n\
+    <regions>\n\
+        <UK><box hostname='UK1'/><box hostname='UK2'/></UK>\n\
+    </regions>\n\
+</deployment>\n"}.name("s1")};
+    config deployment{"deployment", "i1"};
+    deployment << s1;
+    const std::string filename{"test_config_image.bin"};
+    EXPECT_CONFIG_ERROR(
+        deployment.save(jet::config_image{filename}),
+        equal("Initialization of config 'deployment..i1' is not finished"));
+    deployment << jet::lock;
+    deployment.save(jet::config_image{filename});
+
+    const config image{jet::config_image{filename}};
+    EXPECT_EQ("deployment", image.app_name());
+    EXPECT_EQ("i1", image.instance_name());
+    EXPECT_EQ(4, image.get<int>("threads"));
+    EXPECT_EQ(0.5, image.get<double>("ratio"));
+    EXPECT_EQ("UK2", image.get_children_of("regions.UK")[1].get("hostname"));
+    EXPECT_EQ("deployment..i1.regions.UK", image.get_node("regions.UK").name());
+    {
+        std::stringstream expected, actual;
+        expected << deployment;
+        actual << image;
+        EXPECT_EQ(expected.str(), actual.str());
+    }
+    {//...nodes right after the header are overwritten, size of file stays the same
+        std::fstream file{filename, std::ios::in | std::ios::out | std::ios::binary};
+        file.seekp(64);
+        file << std::string(64, '\xff');
+    }
+    EXPECT_CONFIG_ERROR(
+        jet::config{jet::config_image{filename}},
+        equal
+            ("Couldn't open config image 'test_config_image.bin'")
+            ("Config image is corrupted"));
+    std::ofstream{filename} << "<deployment/>";
+    EXPECT_CONFIG_ERROR(
+        jet::config{jet::config_image{filename}},
+        equal
+            ("Couldn't open config image 'test_config_image.bin'")
+            ("Config image is truncated: 13 bytes"));
+    EXPECT_CONFIG_ERROR(
+        jet::config{jet::config_image{"unknown_config_image.bin"}},
+        start_with("Couldn't open config image 'unknown_config_image.bin'"));
+    std::remove(filename.c_str());
+}
+
 TEST(config, get_children_of_root)
 {
     const config_source s1{config_source::from_string{
@@ -792,6 +1403,37 @@ TEST(config, get_value_of_intermidiate_node)
         equal("Node 'deployment.UK' is intermidiate node without value"));
 }
 
+TEST(config, get_from_repeating_nodes)
+{
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <box hostname='b1'><port>1</port></box>\n\
+    <box hostname='b2'><port>2</port><extra>e2</extra></box>\n\
+    <box hostname='b3'/>\n\
+</app>\n"}.name("s1")};
+    config config{"app"};
+    config << s1 << jet::lock;
+
+    //...path lookup always resolves to the first of repeating nodes
+    EXPECT_EQ("b1", config.get("box.hostname"));
+    EXPECT_EQ(1, config.get<int>("box.port"));
+    EXPECT_EQ(boost::none, config.get_optional("box.extra"));
+
+    //...but lookup relative to any of them stays inside that node
+    const jet::config_nodes boxes{config.get_children_of()};
+    ASSERT_EQ(3U, boxes.size());
+    EXPECT_EQ("b2", boxes[1].get("hostname"));
+    EXPECT_EQ(2, boxes[1].get<int>("port"));
+    EXPECT_EQ("e2", boxes[1].get_node("extra").get());
+    EXPECT_EQ("b3", boxes[2].get("hostname"));
+    EXPECT_EQ(boost::none, boxes[2].get_optional("port"));
+    EXPECT_EQ(boost::none, config.get_optional("box..port"));
+    EXPECT_EQ(boost::none, config.get_optional("box.port."));
+    EXPECT_CONFIG_ERROR(
+        config.get_children_of("unknown"),
+        equal("config 'app' doesn't have child 'unknown'"));
+}
+
 TEST(config, repeating_node_merge_without_conflicts)
 {
     const config_source s1{config_source::from_string{
@@ -874,6 +1516,545 @@ TEST(config, repeating_node_merge_with_conflicts2)
         equal("Can't do ambiguous merge of node 'key' from config source 's2' to config 'app'"));
 }
 
+TEST(config, source_batch)
+{
+    jet::config_source_batch batch;
+    for(int i = 0; i < 16; ++i)
+        batch << config_source::from_string{
+            "<app><value>" + std::to_string(i) + "</value><v" + std::to_string(i) + "/></app>"}
+            .name("s" + std::to_string(i));
+    ASSERT_EQ(16U, batch.size());
+    const std::vector<config_source> sources{batch.create(4)};
+    ASSERT_EQ(16U, sources.size());
+    for(size_t i = 0; i < sources.size(); ++i)
+        EXPECT_EQ("s" + std::to_string(i), sources[i].name());
+
+    config app{"app"};
+    app << sources << jet::lock;
+    EXPECT_EQ(15, app.get<int>("value"));
+    EXPECT_EQ(17U, app.get_children_of("").size());
+
+    batch
+        << config_source::from_string{"invalid1"}.name("invalid1")
+        << config_source::from_string{"invalid2"}.name("invalid2");
+    EXPECT_CONFIG_ERROR(
+        batch.create(),
+        equal
+            ("Couldn't parse config 'invalid1'")
+            ("<unspecified file>(1): expected <"));
+}
+
+TEST(config, interned_keys)
+{
+    const config_source s1{config_source::from_string{
+"<deployment>\n\
+    <instance><i1><threads>4</threads></i1><i2><threads>8</threads></i2></instance>\n\
+    <regions><UK><box hostname='UK1'/></UK></regions>\n\
+</deployment>\n"}.name("s1")};
+    config i1{"deployment", "i1"}, i2{"deployment", "i2"};
+    i1 << s1 << jet::lock;
+    i2 << s1 << jet::lock;
+    EXPECT_EQ(4, i1.get<int>("threads"));
+    EXPECT_EQ(8, i2.get<int>("threads"));
+    const jet::config_node uk1{i1.get_node("regions.UK")}, uk2{i2.get_node("regions.UK")};
+    EXPECT_EQ("regions.UK", uk1.path());
+    EXPECT_EQ("UK", uk1.node_name());
+    EXPECT_EQ("regions.UK.box", uk2.get_node("box").path());
+    EXPECT_TRUE(jet::diff(uk1, uk2).empty());//...names interned by both configs are matched by symbols
+    const jet::config_changes changes{jet::diff(i1, i2)};
+    ASSERT_EQ(1U, changes.size());
+    EXPECT_EQ("threads", changes[0].path);
+
+    const std::string filename{"test_config_keys.bin"};
+    i1.save(jet::config_image{filename});
+    const config image{jet::config_image{filename}};
+    EXPECT_EQ("regions.UK.box", image.get_node("regions.UK.box").path());
+    EXPECT_EQ("UK1", image.get("regions.UK.box.hostname"));
+    EXPECT_TRUE(jet::diff(i1, image).empty());
+    std::remove(filename.c_str());
+}
+
+TEST(config, case_insensitive_lookup)
+{
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <Threads>4</Threads>\n\
+    <Connection_Settings><RetryTimeout>10</RetryTimeout></Connection_Settings>\n\
+    <box>first</box><BOX>second</BOX>\n\
+</app>\n"}.name("s1")};
+    config sensitive{"app"}, insensitive{"app", "", config::case_insensitive};
+    sensitive << s1 << jet::lock;
+    insensitive << s1 << jet::lock;
+    EXPECT_EQ(4, sensitive.get<int>("Threads"));
+    EXPECT_FALSE(sensitive.get_optional("threads"));
+    EXPECT_EQ(4, insensitive.get<int>("threads"));
+    EXPECT_EQ(4, insensitive.get<int>("THREADS"));
+    EXPECT_EQ(10, insensitive.get<int>("connection_settings.retrytimeout"));
+    EXPECT_EQ(10, insensitive.get_node("CONNECTION_SETTINGS").get<int>("retryTimeout"));
+    EXPECT_EQ("Connection_Settings", insensitive.get_node("connection_settings").node_name());
+    EXPECT_EQ("first", insensitive.get("Box"));
+    EXPECT_FALSE(insensitive.get_optional("box.x"));
+
+    const std::string filename{"test_config_case.bin"};
+    insensitive.save(jet::config_image{filename});
+    const config image{jet::config_image{filename}};
+    EXPECT_EQ(10, image.get<int>("connection_settings.RETRYTIMEOUT"));
+    std::remove(filename.c_str());
+}
+
+TEST(config, memory_usage)
+{
+    const auto make_source = [](bool equal_values)
+        {
+            std::string text{"<app>"};
+            for(int i = 0; i < 100; ++i)
+                text += "<node" + std::to_string(i) + ">" + std::string(32, 'a') +
+                    (equal_values ? std::string{} : std::to_string(i)) + "</node" + std::to_string(i) + ">";
+            return config_source{config_source::from_string{text + "</app>"}};
+        };
+    const config_source equal_values{make_source(true)}, distinct_values{make_source(false)};
+    EXPECT_LT(100U * 32, equal_values.memory_usage());
+
+    config app1{"app"}, app2{"app"};
+    app1 << equal_values;
+    app2 << distinct_values;
+    const size_t unlocked_usage{app1.memory_usage()};
+    EXPECT_LT(100U * 32, unlocked_usage);
+    app1 << jet::lock;
+    app2 << jet::lock;
+    EXPECT_LT(app1.memory_usage(), unlocked_usage);
+    EXPECT_LT(app1.memory_usage() + 99 * 32, app2.memory_usage());//...equal values are stored once
+    EXPECT_EQ(std::string(32, 'a'), app1.get("node99"));
+    EXPECT_EQ(std::string(32, 'a') + "99", app2.get("node99"));
+
+    const size_t key_usage{config::key_memory_usage()};
+    size_t locked_key_usage{};
+    {
+        std::string text{"<app>"};
+        for(int i = 0; i < 100; ++i)
+            text += "<memory_usage_key" + std::string(32, 'k') + std::to_string(i) + ">1</memory_usage_key" +
+                std::string(32, 'k') + std::to_string(i) + ">";
+        config keys{"app"};
+        keys << config_source{config_source::from_string{text + "</app>"}} << jet::lock;
+        locked_key_usage = config::key_memory_usage();
+        EXPECT_LT(key_usage + 100 * 32, locked_key_usage);
+    }
+    EXPECT_LT(config::key_memory_usage() + 100 * 32, locked_key_usage);//...names are freed with config
+}
+
+TEST(config, diff)
+{
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <server threads='4' port='80'/>\n\
+    <limits><cpu>1</cpu><memory>2</memory></limits>\n\
+    <box host='b1'/><box host='b2'/>\n\
+    <removed>1</removed>\n\
+</app>\n"}};
+    const config_source s2{config_source::from_string{
+"<app>\n\
+    <server threads='8' port='80'/>\n\
+    <limits><cpu>1</cpu><memory>2</memory></limits>\n\
+    <box host='b1'/><box host='b3'/><box host='b4'/>\n\
+    <added><value>1</value></added>\n\
+</app>\n"}};
+    config c1{"app"}, c2{"app"};
+    c1 << s1 << jet::lock;
+    c2 << s2 << jet::lock;
+
+    const jet::config_changes changes{jet::diff(c1, c2)};
+    ASSERT_EQ(5U, changes.size());
+    EXPECT_EQ("server.threads", changes[0].path);
+    EXPECT_EQ(std::string{"4"}, changes[0].old_value);
+    EXPECT_EQ(std::string{"8"}, changes[0].new_value);
+    EXPECT_EQ("box.host", changes[1].path);
+    EXPECT_EQ(std::string{"b2"}, changes[1].old_value);
+    EXPECT_EQ(std::string{"b3"}, changes[1].new_value);
+    EXPECT_EQ("box.host", changes[2].path);
+    EXPECT_EQ(boost::none, changes[2].old_value);
+    EXPECT_EQ(std::string{"b4"}, changes[2].new_value);
+    EXPECT_EQ("added.value", changes[3].path);
+    EXPECT_EQ("removed", changes[4].path);
+    EXPECT_EQ(std::string{"1"}, changes[4].old_value);
+    EXPECT_EQ(boost::none, changes[4].new_value);
+
+    EXPECT_TRUE(jet::diff(c1, c1).empty());
+    EXPECT_TRUE(jet::diff(c1.get_node("limits"), c2.get_node("limits")).empty());
+    ASSERT_EQ(1U, jet::diff(c1.get_node("server"), c2.get_node("server")).size());
+    EXPECT_EQ("threads", jet::diff(c1.get_node("server"), c2.get_node("server"))[0].path);
+}
+
+TEST(config, factory)
+{
+    const config_source s1{config_source::from_string{
+"<config><default><net timeout='5'/></default><app>\n\
+    <server threads='4' port='80'><log level='info'/></server>\n\
+    <limits><cpu>1</cpu><memory>2</memory></limits>\n\
+    <box host='b1'/><box host='b2'/>\n\
+    <instance>\n\
+        <i1><server threads='8'><log file='i1.log'/></server><limits/></i1>\n\
+        <i3><box host='b3'/></i3>\n\
+    </instance>\n\
+</app></config>\n"}.name("s1")};
+    const config_source s2{config_source::from_string{
+"<app>\n\
+    <instance>\n\
+        <i1><extra><value>1</value></extra></i1>\n\
+        <i2><server><port>81</port></server></i2>\n\
+    </instance>\n\
+</app>\n"}.name("s2")};
+    const std::vector<config_source> sources{s1, s2};
+    const jet::config_factory factory{"app", sources};
+    const auto expect_same = [&sources](const config& created, const std::string& instance_name)
+        {
+            config expected{"app", instance_name};
+            expected << sources << jet::lock;
+            EXPECT_EQ(expected.name(), created.name());
+            EXPECT_TRUE(jet::diff(expected, created).empty());
+            EXPECT_TRUE(jet::diff(created, expected).empty());
+            std::stringstream expected_text, created_text;
+            expected_text << expected;
+            created_text << created;
+            EXPECT_EQ(expected_text.str(), created_text.str());
+        };
+    expect_same(factory.create(), "");
+    expect_same(factory.create(" i1 "), "i1");
+    expect_same(factory.create("i2"), "i2");
+    expect_same(factory.create("unknown"), "unknown");
+
+    const config i1{factory.create("i1")};
+    EXPECT_EQ(8, i1.get<int>("server.threads"));
+    EXPECT_EQ("80", i1.get("server.port"));//...merged node keeps not overridden properties
+    EXPECT_EQ("info", i1.get("server.log.level"));
+    EXPECT_EQ("i1.log", i1.get("server.log.file"));
+    EXPECT_EQ(boost::none, i1.get_optional("limits.cpu"));//...empty instance node replaces the node
+    EXPECT_EQ(1, i1.get<int>("extra.value"));
+    EXPECT_EQ(5, i1.get<int>("net.timeout"));
+    ASSERT_EQ(6U, i1.get_children_of().size());
+    EXPECT_EQ("b2", i1.get_children_of()[4].get("host"));
+    EXPECT_EQ("app..i1.box", i1.get_children_of()[4].name());
+
+    const config i2{factory.create("i2")};
+    EXPECT_EQ(81, i2.get<int>("server.port"));
+    EXPECT_EQ(2, i2.get_node("limits").get<int>("memory"));//...subtree shared with base
+    EXPECT_EQ("app..i2.limits.memory", i2.get_node("limits.memory").name());
+    EXPECT_EQ("info", i2.get_node("server").get("log.level"));
+    EXPECT_EQ("b1", i2.get("box.host"));
+    EXPECT_EQ(2U, i2.get_children_of("limits").size());
+    EXPECT_TRUE(jet::diff(i2.get_node("limits"), factory.create().get_node("limits")).empty());
+    EXPECT_LT(i2.memory_usage(), factory.memory_usage());
+
+    config i3{"app", "i3"};
+    i3 << sources;
+    EXPECT_CONFIG_ERROR(
+        i3 << jet::lock,
+        equal("Can't do ambiguous merge of node 'box' from config source 'app..i3' to config 'config.default'"));
+    EXPECT_CONFIG_ERROR(
+        factory.create("i3"),
+        equal("Can't do ambiguous merge of node 'box' from config source 'app..i3' to config 'config.default'"));
+
+    const std::string filename{"test_config_factory_image.bin"};
+    i2.save(jet::config_image{filename});
+    expect_same(config{jet::config_image{filename}}, "i2");
+    std::remove(filename.c_str());
+
+    const jet::config_factory insensitive{"app", sources, config::case_insensitive};
+    EXPECT_EQ(81, insensitive.create("i2").get<int>("Server.Port"));
+    EXPECT_EQ(2, insensitive.create("i2").get<int>("LIMITS.memory"));
+}
+
+namespace
+{
+struct server_settings
+{
+    int threads;
+    double ratio;
+    std::string host;
+    unsigned short port;
+    std::chrono::milliseconds timeout;
+};
+constexpr auto threads_field = jet::make_config_field("threads", &server_settings::threads).range(1, 64);
+constexpr auto port_field = jet::make_config_field("port", &server_settings::port).default_value(80);
+}//anonymous namespace
+
+TEST(config, schema)
+{
+    const auto schema = jet::make_config_schema<server_settings>(
+        threads_field,
+        jet::make_config_field("limits.ratio", &server_settings::ratio).range(0.0, 1.0),
+        jet::make_config_field("host", &server_settings::host).default_value("localhost"),
+        port_field,
+        jet::make_config_field("timeout", &server_settings::timeout)
+            .default_value(std::chrono::milliseconds{100})
+            .range(std::chrono::milliseconds{1}, std::chrono::seconds{1}));
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <server threads='8'><limits ratio='0.5'/></server>\n\
+    <broken threads='100' port='http' timeout='5s'><limits ratio='2'/></broken>\n\
+</app>\n"}.name("s1")};
+    config cfg{"app"};
+    cfg << s1;
+    EXPECT_CONFIG_ERROR(
+        schema.bind(cfg.get_node("server")),
+        equal("Initialization of config 'app' is not finished"));
+    cfg << jet::lock;
+
+    const server_settings server{schema.bind(cfg.get_node("server"))};
+    EXPECT_EQ(8, server.threads);
+    EXPECT_EQ(0.5, server.ratio);
+    EXPECT_EQ("localhost", server.host);
+    EXPECT_EQ(80, server.port);
+    EXPECT_EQ(std::chrono::milliseconds{100}, server.timeout);
+
+    EXPECT_CONFIG_ERROR(
+        schema.bind(cfg.get_node("broken")),
+        equal("Config 'app.broken' doesn't match schema: "
+            "value 100 of property 'threads' is out of range [1, 64]; "
+            "value 2 of property 'limits.ratio' is out of range [0, 1]; "
+            "Can't convert value 'http' of a property 'port' in config 'app.broken'; "
+            "value 5s of property 'timeout' is out of range [0.001s, 1s]"));
+    EXPECT_CONFIG_ERROR(
+        schema.bind(cfg),
+        equal("Config 'app' doesn't match schema: "
+            "property 'threads' is missing; property 'limits.ratio' is missing"));
+    EXPECT_CONFIG_ERROR(
+        jet::make_config_schema<server_settings>(
+            jet::make_config_field("limits", &server_settings::host).default_value("localhost"))
+            .bind(cfg.get_node("server")),
+        equal("Config 'app.server' doesn't match schema: "
+            "Node 'app.server.limits' is intermidiate node without value"));
+}
+
+TEST(config, get_array)
+{
+    const config_source s1{config_source::from_string{
+"<app>\n\
+    <table>\n\
+        <w>1</w>\n\
+        <w> 2, 3 </w>\n\
+        <scale>0.5</scale>\n\
+        <name>table</name>\n\
+        <w>4</w>\n\
+        <empty/>\n\
+        <bad>1,x,3</bad>\n\
+        <gap/><gap>5</gap>\n\
+    </table>\n\
+    <ports list='80,8080'/>\n\
+    <instance><i1><table><scale>0.25,0.75</scale></table></i1></instance>\n\
+</app>\n"}.name("s1")};
+    config cfg{"app"};
+    cfg << s1 << jet::lock;
+    const jet::config_array<std::int64_t> weights{cfg.get_array<std::int64_t>("table.w")};
+    EXPECT_EQ((std::vector<std::int64_t>{1, 2, 3, 4}), std::vector<std::int64_t>(weights.begin(), weights.end()));
+    EXPECT_EQ(weights.data() + 1, &weights[1]);
+    const jet::config_array<double> doubles{cfg.get_array<double>("table.w")};
+    EXPECT_EQ((std::vector<double>{1, 2, 3, 4}), std::vector<double>(doubles.begin(), doubles.end()));
+    EXPECT_EQ(0.5, cfg.get_node("table").get_array<double>("scale")[0]);
+    EXPECT_EQ(1U, cfg.get_array<double>("table.scale").size());
+    EXPECT_TRUE(cfg.get_array<std::int64_t>("table.empty").empty());
+    EXPECT_EQ(5, cfg.get_array<std::int64_t>("table.gap")[0]);
+    EXPECT_EQ(8080, cfg.get_array<std::int64_t>("ports.list")[1]);
+    EXPECT_EQ("1", cfg.get("table.w"));
+
+    const jet::config_nodes table{cfg.get_children_of("table")};
+    EXPECT_EQ(2U, table[1].get_array<std::int64_t>().size());
+    EXPECT_EQ(4, table[4].get_array<std::int64_t>()[0]);
+
+    EXPECT_CONFIG_ERROR(
+        cfg.get_array<std::int64_t>("table.scale"),
+        equal("Can't convert element 0 '0.5' of an array property 'table.scale' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        cfg.get_array<double>("table.bad"),
+        equal("Can't convert element 1 'x' of an array property 'table.bad' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        cfg.get_array<double>("table.name"),
+        equal("Can't convert element 0 'table' of an array property 'table.name' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        cfg.get_array<double>("table.none"),
+        equal("Can't find property 'table.none' in config 'app'"));
+    EXPECT_CONFIG_ERROR(
+        cfg.get_array<double>("table"),
+        equal("Node 'app.table' is intermidiate node without value"));
+
+    const jet::config_factory factory{"app", {s1}};
+    const config i1{factory.create("i1")};
+    const jet::config_array<double> scale{i1.get_array<double>("table.scale")};
+    EXPECT_EQ((std::vector<double>{0.25, 0.75}), std::vector<double>(scale.begin(), scale.end()));
+    EXPECT_EQ(4U, i1.get_array<std::int64_t>("table.w").size());
+    EXPECT_EQ(80, i1.get_array<std::int64_t>("ports.list")[0]);
+
+    const std::string filename{"test_config_array_image.bin"};
+    i1.save(jet::config_image{filename});
+    const config image{jet::config_image{filename}};
+    std::remove(filename.c_str());
+    EXPECT_EQ(3, image.get_array<std::int64_t>("table.w")[2]);
+    EXPECT_EQ(0.75, image.get_array<double>("table.scale")[1]);
+}
+
+TEST(config, concurrent_reads)
+{//...readers start before config is locked: every read either throws (config isn't locked yet)
+ //...or sees the whole locked config, once a read succeeds all the next reads have to succeed
+    static const int sections{100}, readers_count{8}, reads_per_reader{2000};
+    std::string text{"<app>"};
+    for(int section = 0; section < sections; ++section)
+    {
+        const std::string name{"section" + std::to_string(section)};
+        text += '<' + name + " id='" + std::to_string(section) + "'><item>1</item><item>2</item></" + name + '>';
+    }
+    text += "</app>";
+    config cfg{"app"};
+    cfg << config_source{config_source::from_string{text}};
+
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for(int reader = 0; reader < readers_count; ++reader)
+    {
+        readers.emplace_back([&cfg, &errors, reader]()
+            {
+                bool locked{false};
+                for(int read = 0; read < reads_per_reader;)
+                {
+                    const int section{(reader * 13 + read) % sections};
+                    const std::string path{"section" + std::to_string(section)};
+                    try
+                    {
+                        const jet::config_node node{cfg.get_node(path)};
+                        const std::vector<jet::config_node> children{node.get_children_of()};
+                        if( section != node.get<int>("id") ||
+                            section != cfg.get<int>(path + ".id") ||
+                            path != node.path_view() ||
+                            3 != children.size() ||
+                            "2" != children[2].get_view() ||
+                            sections != static_cast<int>(cfg.children_of().size()) )
+                            ++errors;
+                        locked = true;
+                        ++read;
+                    }
+                    catch(const jet::config_error&)
+                    {
+                        if(locked)
+                            ++errors;
+                    }
+                }
+            });
+    }
+    cfg << jet::lock;
+    for(std::thread& reader : readers)
+        reader.join();
+    EXPECT_EQ(0, errors.load());
+}
+
+TEST(reloadable_config, reload)
+{
+    std::string text{"<app><timeout>1</timeout></app>"};
+    jet::reloadable_config cfg{"app", "i1", [&text]()
+        {
+            return std::vector<config_source>{config_source{config_source::from_string{text}.name("s1")}};
+        }};
+    EXPECT_EQ(1U, cfg.version());
+    const jet::reloadable_config::snapshot first{cfg};
+    EXPECT_EQ(1U, first.version());
+    EXPECT_EQ(1, first->get<int>("timeout"));
+
+    text = "<app><timeout>2</timeout></app>";
+    cfg.reload();
+    EXPECT_EQ(2U, cfg.version());
+    EXPECT_EQ(1, first->get<int>("timeout"));
+    {
+        const jet::reloadable_config::snapshot second{cfg};
+        EXPECT_EQ(2U, second.version());
+        EXPECT_EQ(2, (*second).get<int>("timeout"));
+    }
+
+    text = "invalid";
+    EXPECT_CONFIG_ERROR(
+        cfg.reload(),
+        equal
+            ("Couldn't load version 3 of config 'app..i1'")
+            ("Couldn't parse config 's1'")
+            ("<unspecified file>(1): expected <"));
+    EXPECT_EQ(2U, cfg.version());
+    EXPECT_EQ(2, jet::reloadable_config::snapshot{cfg}->get<int>("timeout"));
+}
+
+TEST(reloadable_config, subscribe)
+{
+    std::string text{"<app><server threads='4' port='80'/><limits cpu='1' memory='2'/></app>"};
+    jet::reloadable_config cfg{"app", "", [&text]()
+        {
+            return std::vector<config_source>{config_source{config_source::from_string{text}}};
+        }};
+    std::vector<std::string> threads, limits, all;
+    cfg.subscribe("server.threads", [&threads](const jet::config_change& change)
+        {
+            threads.push_back(*change.old_value + "->" + *change.new_value);
+        });
+    const jet::reloadable_config::subscription_id limits_id{cfg.subscribe("limits.*",
+        [&limits](const jet::config_change& change)
+        {
+            limits.push_back(change.path + '=' + change.new_value.value_or("none"));
+        })};
+    cfg.subscribe("*", [&all](const jet::config_change& change) { all.push_back(change.path); });
+
+    text = "<app><server threads='4' port='81'/><limits cpu='1' memory='2'/></app>";
+    cfg.reload();
+    EXPECT_TRUE(threads.empty());
+    EXPECT_TRUE(limits.empty());
+    EXPECT_EQ(std::vector<std::string>{"server.port"}, all);
+
+    text = "<app><server threads='8' port='81'/><limits cpu='2'/></app>";
+    cfg.reload();
+    EXPECT_EQ(std::vector<std::string>{"4->8"}, threads);
+    EXPECT_EQ((std::vector<std::string>{"limits.cpu=2", "limits.memory=none"}), limits);
+    EXPECT_EQ((std::vector<std::string>{"server.port", "server.threads", "limits.cpu", "limits.memory"}), all);
+
+    cfg.unsubscribe(limits_id);
+    text = "<app><server threads='8' port='81'/><limits cpu='3'/></app>";
+    cfg.reload();
+    EXPECT_EQ(2U, limits.size());
+    EXPECT_EQ(5U, all.size());
+}
+
+TEST(reloadable_config, concurrent_readers)
+{//...every version of config has equal 'first' and 'second' properties
+    std::atomic<int> value{0};
+    jet::reloadable_config cfg{"app", "", [&value]()
+        {
+            const std::string text{std::to_string(value.load())};
+            return std::vector<config_source>{config_source{config_source::from_string{
+                "<app><first>" + text + "</first><second>" + text + "</second></app>"}}};
+        }};
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for(int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&cfg, &stop, &errors]()
+            {
+                std::uint64_t last_version{};
+                while(!stop.load())
+                {
+                    const jet::reloadable_config::snapshot current{cfg};
+                    if( current->get<int>("first") != current->get<int>("second") ||
+                        current.version() < last_version )
+                        ++errors;
+                    last_version = current.version();
+                }
+            });
+    }
+    for(int i = 1; i <= 100; ++i)
+    {
+        value = i;
+        cfg.reload();
+    }
+    stop = true;
+    for(std::thread& reader : readers)
+        reader.join();
+    EXPECT_EQ(0, errors.load());
+    EXPECT_EQ(101U, cfg.version());
+    EXPECT_EQ(100, jet::reloadable_config::snapshot{cfg}->get<int>("first"));
+}
+
 //TODO: introduce proper boolean property
 //TODO: introduce "sequence of properties/elements" for repeating data
 //TODO: (SourceConfig) prohibit '.' separator everywhere except application name